@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "motion_program.hpp"
+#include "odometry.hpp"
+#include "pros/link.hpp"
+
+namespace ez {
+
+/**
+ * Set in link_state flags when the pose is in field coordinates.
+ */
+constexpr uint8_t LINK_FIELD_POSE = 1;
+
+/**
+ * State one robot sends its alliance partner, packed to keep radio packets small.
+ */
+struct __attribute__((__packed__)) link_state {
+  uint8_t version;
+  uint8_t sequence;
+  int16_t x;         // 0.1 inches, field coordinates
+  int16_t y;         // 0.1 inches, field coordinates
+  int16_t theta;     // 0.1 degrees, field coordinates
+  int8_t step;       // motion program step, -1 if none is running
+  uint8_t flags;     // ez::LINK_FIELD_POSE if the pose is on the field
+  uint32_t claimed;  // One bit per field element
+};
+
+class AllianceLink {
+ public:
+  /**
+   * Max amount of field elements that can be claimed.
+   */
+  static constexpr int MAX_ELEMENTS = 32;
+
+  /**
+   * Shares pose, the running auton step and claimed field elements with the alliance partner over VEXlink.
+   *
+   * Every packet has the whole state, so lost packets are just skipped.  Nothing waits on the radio.
+   * Poses are sent in field coordinates, so only once origin_set() says where odometry's (0, 0, 0) is on the field.
+   *
+   * Run iterate() on the control tick.
+   *
+   * \param port
+   *        port the radio is plugged into
+   * \param odometry
+   *        odometry whose pose is sent
+   * \param runner
+   *        motion runner whose step is sent
+   */
+  AllianceLink(int port, Odometry& odometry, MotionRunner& runner);
+
+  /**
+   * Starts the link.  One robot of the pair has to be the transmitter.
+   *
+   * \param id
+   *        link id, both robots need the same one
+   * \param transmitter
+   *        true if this robot is the transmitter
+   */
+  void start(const char* id, bool transmitter);
+
+  /**
+   * Sends packets to ourselves instead of the radio, so everything can be checked with one robot.
+   *
+   * \param enable
+   *        true enables, false disables
+   */
+  void loopback_set(bool enable);
+
+  /**
+   * Sets how often state is sent.
+   *
+   * \param ms
+   *        ms between packets, defaults to 50
+   */
+  void period_set(int ms);
+
+  /**
+   * Sets where this robot's odometry (0, 0, 0) is on the field.  Poses are sent in field coordinates from then on.
+   *
+   * \param origin
+   *        field pose of odometry's origin, {0, 0, 0} if odometry is already in field coordinates
+   */
+  void origin_set(pose origin);
+
+  /**
+   * Forgets the field origin, ie after odometry was set somewhere unknown.  Poses aren't trusted by the partner until origin_set().
+   */
+  void origin_clear();
+
+  /**
+   * Claims a field element, the partner sees it on their next packet.
+   *
+   * \param element
+   *        0 to MAX_ELEMENTS - 1
+   */
+  void claim(int element);
+
+  /**
+   * Releases a field element.
+   *
+   * \param element
+   *        0 to MAX_ELEMENTS - 1
+   */
+  void release(int element);
+
+  /**
+   * Releases every field element.
+   */
+  void release_all();
+
+  /**
+   * Returns true if we claimed a field element.
+   *
+   * \param element
+   *        0 to MAX_ELEMENTS - 1
+   */
+  bool claimed(int element);
+
+  /**
+   * Returns true if the partner is fresh and claimed a field element.  Claims are dropped when the partner goes quiet.
+   *
+   * \param element
+   *        0 to MAX_ELEMENTS - 1
+   */
+  bool partner_claimed(int element);
+
+  /**
+   * Returns the partner's last pose in field coordinates.
+   */
+  pose partner_pose_get();
+
+  /**
+   * Returns the step the partner's motion program is on, or -1 if none is running.
+   */
+  int partner_step_get();
+
+  /**
+   * Returns ms since the partner's last packet, or -1 if none has come in.
+   */
+  int partner_age_get();
+
+  /**
+   * Returns true if the partner's last packet is recent enough to trust their pose.
+   */
+  bool partner_fresh();
+
+  /**
+   * Returns true if the partner is fresh, knows its field pose and is within a radius of a point, ie to skip going there.
+   *
+   * \param x
+   *        field x in inches
+   * \param y
+   *        field y in inches
+   * \param radius
+   *        radius in inches
+   */
+  bool partner_near(double x, double y, double radius);
+
+  /**
+   * Sends and receives state.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Prints the link status and the partner's state.
+   */
+  void print();
+
+ private:
+  int port;
+  Odometry* odometry;
+  MotionRunner* runner;
+  pros::Link* link = nullptr;
+  bool loopback = false;
+  bool has_loopback_packet = false;
+  link_state loopback_packet = {};
+  int period = 50;
+  int timer = 0;
+  std::atomic<uint32_t> claims = 0;
+  pros::Mutex origin_mutex;
+  pose origin = {0.0, 0.0, 0.0};
+  bool has_origin = false;
+  link_state partner = {};
+  uint32_t partner_time = 0;
+  bool partner_seen = false;
+  uint8_t sequence = 0;
+  int sent = 0;
+  int received = 0;
+  int lost = 0;
+  void packet_handle(const link_state& packet);
+};
+}  // namespace ez
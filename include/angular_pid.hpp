@@ -0,0 +1,183 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+class AngularPID {
+ public:
+  /**
+   * PID for headings, in degrees with the same per tick constants as ez::PID.
+   *
+   * Which way to go around is decided once in target_set(), so compute() has no angle logic.
+   * The derivative is taken on the measurement (or a gyro rate) instead of the error, so new targets don't kick,
+   * and it's low pass filtered to take out IMU noise.
+   */
+  AngularPID();
+
+  /**
+   * PID for headings, in degrees with the same per tick constants as ez::PID.
+   *
+   * \param p
+   *        kP
+   * \param i
+   *        kI
+   * \param d
+   *        kD
+   * \param start_i
+   *        error value that i starts within
+   */
+  AngularPID(double p, double i = 0.0, double d = 0.0, double start_i = 0.0);
+
+  /**
+   * Sets PID constants.
+   *
+   * \param p
+   *        kP
+   * \param i
+   *        kI
+   * \param d
+   *        kD
+   * \param start_i
+   *        error value that i starts within
+   */
+  void constants_set(double p, double i = 0.0, double d = 0.0, double start_i = 0.0);
+
+  /**
+   * Sets PID constants from an ez::PID, ie the chassis' turnPID.
+   *
+   * \param constants
+   *        constants to copy
+   */
+  void constants_set(PID::Constants constants);
+
+  /**
+   * Returns PID constants.
+   */
+  PID::Constants constants_get();
+
+  /**
+   * Sets how much of each new derivative sample is kept.
+   *
+   * \param amount
+   *        0 to 1, 1 is no filtering.  Defaults to 0.5
+   */
+  void derivative_filter_set(double amount);
+
+  /**
+   * Sets exit conditions, these work like ez::PID's.
+   *
+   * \param small_exit_time
+   *        time in ms within small_error before exiting
+   * \param small_error
+   *        small error threshold in degrees
+   * \param big_exit_time
+   *        time in ms within big_error before exiting
+   * \param big_error
+   *        big error threshold in degrees
+   * \param velocity_exit_time
+   *        time in ms the heading has to stop changing for before exiting
+   */
+  void exit_condition_set(int small_exit_time, double small_error, int big_exit_time = 0, double big_error = 0.0, int velocity_exit_time = 0);
+
+  /**
+   * Sets a new target.  The way around is picked here and kept until the next target.
+   *
+   * Integral and the derivative filter carry over, so chaining targets doesn't jerk the robot.
+   *
+   * \param target
+   *        target heading in degrees
+   * \param current
+   *        current heading in degrees
+   * \param behavior
+   *        ez::shortest, ez::longest, ez::cw, ez::ccw or ez::raw.  Defaults to shortest
+   */
+  void target_set(double target, double current, e_angle_behavior behavior = shortest);
+
+  /**
+   * Returns the target.  This isn't wrapped, so it can be more than 180 degrees from the current heading.
+   */
+  double target_get();
+
+  /**
+   * Computes output, derivative is the change in heading since the last compute.  Run this every ez::util::DELAY_TIME.
+   *
+   * \param current
+   *        current heading in degrees
+   */
+  double compute(double current);
+
+  /**
+   * Computes output, derivative is a gyro rate instead of the change in heading.
+   *
+   * \param current
+   *        current heading in degrees
+   * \param rate
+   *        rate the heading is changing in degrees per second, positive when the heading is going up
+   */
+  double compute(double current, double rate);
+
+  /**
+   * Returns the last error.
+   */
+  double error_get();
+
+  /**
+   * Returns the last output.
+   */
+  double output_get();
+
+  /**
+   * Resets integral, the derivative filter and exit timers.  Use this before starting from rest.
+   */
+  void variables_reset();
+
+  /**
+   * Returns RUNNING until an exit condition is met, call this after compute().
+   */
+  exit_output exit_condition();
+
+ private:
+  PID::Constants constants = {0.0, 0.0, 0.0, 0.0};
+  double filter = 0.5;
+  double target = 0.0;
+  bool wrap = true;
+  double error = 0.0;
+  double output = 0.0;
+  double integral = 0.0;
+  double derivative = 0.0;
+  double last_current = 0.0;
+  uint32_t last_time = 0;
+  bool started = false;
+  int small_exit_time = 0;
+  double small_error = 0.0;
+  int big_exit_time = 0;
+  double big_error = 0.0;
+  int velocity_exit_time = 0;
+  int small_timer = 0;
+  int big_timer = 0;
+  int velocity_timer = 0;
+  double output_update(double current, double change);
+};
+
+/**
+ * Turns in place to a heading with an AngularPID, this blocks until the turn exits.  Returns false if it timed out before an exit condition was met.
+ *
+ * The chassis is disabled so its own PIDs don't fight this one.  The pid isn't reset, so chained turns carry over smoothly.
+ *
+ * \param drive
+ *        the chassis to turn
+ * \param pid
+ *        the controller to turn with
+ * \param target
+ *        target heading in degrees
+ * \param speed
+ *        max speed, 0 to 127
+ * \param behavior
+ *        which way to turn, defaults to shortest
+ * \param timeout
+ *        most ms the turn can take, defaults to 3000
+ */
+bool angular_turn(Drive& drive, AngularPID& pid, double target, int speed, e_angle_behavior behavior = shortest, int timeout = 3000);
+}  // namespace ez
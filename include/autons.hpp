@@ -1,10 +1,37 @@
 #pragma once
 
 #include "autons.hpp"
+
+// Ids for the actuators motion programs and macros can use
+enum auton_actuators { ARM = 0,
+                       MOGO = 1,
+                       INTAKE = 2,
+                       COLOR_SORT = 3,
+                       DOINK = 4,
+                       HANG = 5,
+                       ARM_PRESET = 6,
+                       CLAIM = 7 };
+
+// Field elements claimed over the alliance link, these are also the ids of triggers that are true when the partner claimed them or is already there
+enum field_elements { ELEMENT_MOGO_LEFT = 0,
+                      ELEMENT_MOGO_RIGHT = 1,
+                      ELEMENT_RING_STACK_LEFT = 2,
+                      ELEMENT_RING_STACK_RIGHT = 3,
+                      ELEMENT_COUNT = 4 };
+
+// Where each field element is on the red side, in field coordinates
+inline constexpr ez::pose ELEMENT_POSITIONS[ELEMENT_COUNT] = {{-28.937, 21.067, 0},
+                                                               {-28.937, -21.067, 0},
+                                                               {-24.381, 44.471, 0},
+                                                               {-24.381, -44.471, 0}};
+
 void default_constants();
+void motion_actuators_set();
+void auton_plan_selected();
 
 void drive_example();
 void turn_example();
+void angular_turn_example();
 void drive_and_turn();
 void wait_until_change_speed();
 void swing_example();
@@ -17,7 +44,6 @@ void odom_pure_pursuit_wait_until_example();
 void odom_boomerang_example();
 void odom_boomerang_injected_pure_pursuit_example();
 void measure_offsets();
-void closeBase();
 void skills();
 void redLeftAWP();
 void blueRightAWP();
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+namespace control_tick {
+
+/**
+ * Max amount of functions that can run on the control tick.
+ */
+constexpr int MAX_CALLBACKS = 16;
+
+/**
+ * Runs a function on the shared control tick task, every ez::util::DELAY_TIME ms or slower.
+ *
+ * The task starts the first time this is called.  Functions can't block, they share one task.
+ *
+ * \param function
+ *        function to run
+ * \param name
+ *        name used when printing timing, this must be a string literal
+ * \param period = util::DELAY_TIME
+ *        how often to run the function in ms, rounded up to the tick
+ */
+void add(std::function<void()> function, const char* name, int period = util::DELAY_TIME);
+
+/**
+ * Prints how long each function has taken on the control tick.
+ */
+void print();
+
+}  // namespace control_tick
+}  // namespace ez
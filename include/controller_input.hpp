@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <initializer_list>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+/**
+ * Enum for controller button events.
+ */
+enum input_event : uint8_t { PRESS = 0,        // Every button is down and one of them was just pressed
+                             RELEASE = 1,      // One of the buttons was just released
+                             HOLD = 2,         // Every button has been down for the hold time
+                             DOUBLE_TAP = 3 };  // Pressed again within the double tap time
+
+class ControllerInput {
+ public:
+  /**
+   * Max amount of handlers that can be registered.
+   */
+  static constexpr int MAX_HANDLERS = 32;
+
+  /**
+   * Reads a controller once per loop and sends button events to handlers.
+   *
+   * \param controller
+   *        the controller to read
+   */
+  ControllerInput(pros::Controller& controller);
+
+  /**
+   * Reads every button and joystick, then runs the handlers for anything that happened.  Run this once every loop.
+   */
+  void update();
+
+  /**
+   * Registers a function to run when a button, or every button in a combo, has an event.
+   *
+   * When a combo runs, handlers for fewer of the same buttons skip that event.  ie B + DOWN stops DOWN.
+   *
+   * \param buttons
+   *        buttons that make up the combo, ie {DIGITAL_B, DIGITAL_DOWN}
+   * \param event
+   *        ez::PRESS, ez::RELEASE, ez::HOLD or ez::DOUBLE_TAP
+   * \param handler
+   *        function to run
+   * \param name
+   *        name used when printing conflicts, this must be a string literal
+   */
+  void on(std::initializer_list<pros::controller_digital_e_t> buttons, input_event event, std::function<void()> handler, const char* name);
+
+  /**
+   * Prints handlers that share buttons for the same event.  Returns how many conflicts there are.
+   */
+  int conflicts_print();
+
+  /**
+   * Returns true if the button is down.
+   *
+   * \param button
+   *        the button to check
+   */
+  bool held(pros::controller_digital_e_t button);
+
+  /**
+   * Returns true if the button was pressed this loop.
+   *
+   * \param button
+   *        the button to check
+   */
+  bool pressed(pros::controller_digital_e_t button);
+
+  /**
+   * Returns true if the button was released this loop.
+   *
+   * \param button
+   *        the button to check
+   */
+  bool released(pros::controller_digital_e_t button);
+
+  /**
+   * Returns a joystick from this loop, -127 to 127.
+   *
+   * \param axis
+   *        the joystick to check
+   */
+  int analog(pros::controller_analog_e_t axis);
+
+  /**
+   * Returns every button as a bitmask, L1 is bit 0 and A is bit 11.
+   */
+  uint16_t buttons_get();
+
+  /**
+   * Sets how long buttons are held down before HOLD runs.
+   *
+   * \param time
+   *        time in ms, defaults to 500
+   */
+  void hold_time_set(int time);
+
+  /**
+   * Sets how quickly a button has to be pressed again for DOUBLE_TAP to run.
+   *
+   * \param time
+   *        time in ms, defaults to 300
+   */
+  void double_tap_time_set(int time);
+
+ private:
+  struct handler {
+    uint16_t mask;
+    input_event event;
+    std::function<void()> function;
+    const char* name;
+    bool hold_done;
+  };
+  pros::Controller* controller;
+  std::array<handler, MAX_HANDLERS> handlers;
+  int handler_count = 0;
+  std::array<int, 4> axes = {};
+  uint16_t down = 0;
+  uint16_t last_down = 0;
+  uint16_t just_pressed = 0;
+  uint16_t just_released = 0;
+  uint16_t double_tapped = 0;
+  std::array<uint32_t, 12> press_time = {};
+  std::array<uint32_t, 12> last_press_time = {};
+  int hold_time = 500;
+  int double_tap_time = 300;
+  bool event_happened(handler& input, uint32_t now);
+};
+}  // namespace ez
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "odometry.hpp"
+#include "portable.hpp"
+#include "pros/serial.hpp"
+
+namespace ez {
+
+/**
+ * Enum for coprocessor message types.
+ */
+enum copro_message : uint8_t { MSG_POSE = 1,        // Brain to coprocessor, copro_pose
+                               MSG_SENSOR = 2,      // Brain to coprocessor, any bytes
+                               MSG_PATH = 3,        // Coprocessor to brain, copro_point list
+                               MSG_CORRECTION = 4,  // Coprocessor to brain, copro_pose of where the robot was
+                               MSG_USER = 16 };     // Types from here up are free to use
+
+/**
+ * Pose with the time it was taken, as sent over the wire.
+ */
+struct __attribute__((__packed__)) copro_pose {
+  uint32_t time;  // ms since the program started
+  float x;        // inches
+  float y;        // inches
+  float theta;    // degrees
+};
+
+/**
+ * Path point, as sent over the wire.
+ */
+struct __attribute__((__packed__)) copro_point {
+  float x;      // inches
+  float y;      // inches
+  float theta;  // degrees, NAN if the point has no heading
+};
+
+class Coprocessor {
+ public:
+  /**
+   * Max payload of one message in bytes.
+   */
+  static constexpr int MAX_PAYLOAD = 240;
+
+  /**
+   * Max points in a path.
+   */
+  static constexpr int MAX_PATH_POINTS = MAX_PAYLOAD / sizeof(copro_point);
+
+  /**
+   * Size of the send and receive buffers in bytes.
+   */
+  static constexpr int BUFFER_SIZE = 2048;
+
+  /**
+   * Talks to a coprocessor over a smart port in serial mode.
+   *
+   * Messages are a type, sequence number, payload and CRC-16, COBS encoded and ended with a 0.
+   * Sending only copies into a ring buffer, a task moves bytes to and from the port so nothing waits on the wire.
+   *
+   * Run iterate() on the control tick to stream pose and apply corrections.
+   *
+   * \param port
+   *        port the coprocessor is plugged into
+   * \param baudrate
+   *        baudrate, defaults to 921600
+   */
+  Coprocessor(int port, int baudrate = 921600);
+
+  /**
+   * Sets the port to serial and starts the task.
+   */
+  void start();
+
+  /**
+   * Streams odometry's pose out and applies corrections coming back to it.
+   *
+   * \param odometry
+   *        odometry to stream and correct
+   * \param period
+   *        ms between poses, defaults to 20
+   */
+  void odometry_set(Odometry& odometry, int period = 20);
+
+  /**
+   * Queues a message to send.  Returns false if it doesn't fit in the send buffer.
+   *
+   * \param type
+   *        message type
+   * \param data
+   *        payload
+   * \param length
+   *        payload length, up to MAX_PAYLOAD
+   */
+  bool send(uint8_t type, const void* data, int length);
+
+  /**
+   * Runs a function when a message of a type comes in.  This runs on the coprocessor task, so it can't block.
+   *
+   * \param type
+   *        message type
+   * \param handler
+   *        function given the payload and its length
+   */
+  void on(uint8_t type, std::function<void(const uint8_t* data, int length)> handler);
+
+  /**
+   * Streams pose and applies corrections.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Returns true if a path came in since the last path_take().
+   */
+  bool path_ready();
+
+  /**
+   * Takes the last path that came in as odom motions.  Returns false if there's no new path.
+   *
+   * \param output
+   *        path is written here
+   * \param dir
+   *        direction to drive the path
+   * \param speed
+   *        speed to drive the path
+   */
+  bool path_take(std::vector<odom>& output, drive_directions dir, int speed);
+
+  /**
+   * Returns ms since the last message came in, or -1 if none has.
+   */
+  int silence_get();
+
+  /**
+   * Prints message counts and errors.
+   */
+  void print();
+
+ private:
+  pros::Serial serial;
+  int baudrate;
+  pros::Task* task = nullptr;
+  pros::Mutex tx_mutex;
+  pros::Mutex rx_mutex;
+  byte_ring<BUFFER_SIZE> tx;
+  frame_collector<MAX_PAYLOAD + 8> rx_frame;
+  std::array<std::function<void(const uint8_t*, int)>, 32> handlers;
+  Odometry* odometry = nullptr;
+  int pose_period = 20;
+  int pose_timer = 0;
+  uint8_t tx_sequence = 0;
+  uint8_t rx_sequence = 0;
+  bool rx_started = false;
+  uint32_t last_receive = 0;
+  std::array<copro_point, MAX_PATH_POINTS> path;
+  int path_length = 0;
+  bool path_new = false;
+  copro_pose correction;
+  bool correction_new = false;
+  int sent = 0;
+  int received = 0;
+  int dropped = 0;
+  int bad_frames = 0;
+  int overflows = 0;
+  void task_run();
+  void frame_handle(const uint8_t* encoded, int length);
+};
+}  // namespace ez
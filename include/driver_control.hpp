@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "angular_pid.hpp"
+#include "api.h"
+#include "controller_input.hpp"
+#include "motor_util.hpp"
+#include "output_stage.hpp"
+
+namespace ez {
+
+/**
+ * Joystick curve stored as a lookup table, one entry for every joystick value.
+ */
+class curve_table {
+ public:
+  /**
+   * Straight line curve, output is the same as the input.
+   */
+  curve_table();
+
+  /**
+   * Fills the table with EZ-Template's exponential curve.  0 is a straight line.
+   *
+   * \param scale
+   *        curve scale, the same value opcontrol_curve_default_set takes
+   */
+  void scale_set(double scale);
+
+  /**
+   * Returns the curve scale, or -1 if a custom curve is used.
+   */
+  double scale_get();
+
+  /**
+   * Fills the table with a custom curve.  Values between points are linearly interpolated.
+   *
+   * Points are {joystick, output} for positive joystick values, negative values mirror them.
+   * {0, 0} and {127, 127} are used if the points don't start and end there.
+   *
+   * \param points
+   *        {joystick, output} pairs sorted by joystick value
+   */
+  void points_set(std::vector<std::pair<double, double>> points);
+
+  /**
+   * Returns the curved joystick value.
+   *
+   * \param joystick
+   *        raw joystick value, -127 to 127
+   */
+  double get(int joystick) const { return table[(uint8_t)(joystick + 128)]; }
+
+ private:
+  std::array<float, 256> table;
+  double scale = 0.0;
+};
+
+class DriverControl {
+ public:
+  /**
+   * Curve used for the left stick, or forward in arcade.
+   */
+  curve_table left_curve;
+
+  /**
+   * Curve used for the right stick, or turning in arcade.
+   */
+  curve_table right_curve;
+
+  /**
+   * Driver control that replaces Drive's opcontrol functions with lookup table curves.
+   *
+   * Active brake, joystick threshold, practice mode and reversing still come from the chassis.
+   *
+   * \param drive
+   *        the chassis to control
+   * \param input
+   *        where joysticks are read from, update() has to run before arcade() or tank()
+   */
+  DriverControl(Drive& drive, ControllerInput& input);
+
+  /**
+   * Sets the chassis to controller joysticks using standard arcade control.  Run this in usercontrol.
+   *
+   * \param stick_type
+   *        ez::SINGLE or ez::SPLIT control
+   */
+  void arcade(e_type stick_type);
+
+  /**
+   * Sets the chassis to controller joysticks using tank control.  Run this in usercontrol.
+   */
+  void tank();
+
+  /**
+   * Replaces the curves with custom curves.  Curve buttons and SD card curves no longer change them.
+   *
+   * \param left
+   *        {joystick, output} points for the left curve
+   * \param right
+   *        {joystick, output} points for the right curve, the left curve is used if this is empty
+   */
+  void curve_custom_set(std::vector<std::pair<double, double>> left, std::vector<std::pair<double, double>> right = {});
+
+  /**
+   * Goes back to EZ-Template's exponential curves.
+   */
+  void curve_custom_clear();
+
+  /**
+   * Sends the drive through an output stage instead of straight to the motors.  Flushing is up to you.
+   *
+   * \param outputs
+   *        output stage the chassis was added to with drive_add
+   */
+  void outputs_set(OutputStage& outputs);
+
+  /////
+  //
+  // Driver Assist
+  //
+  /////
+
+  /**
+   * Holds the robot's heading with the IMU while driving with the turn stick centered.  This uses the chassis headingPID's constants.
+   *
+   * \param enable
+   *        true enables, false disables
+   */
+  void assist_heading_hold_set(bool enable);
+
+  /**
+   * Returns true if heading hold is enabled.
+   */
+  bool assist_heading_hold_enabled();
+
+  /**
+   * Sets how long the turn stick has to be centered before heading is held, so the robot can stop rotating first.
+   *
+   * \param time
+   *        time in ms, defaults to 150
+   */
+  void assist_heading_hold_delay_set(int time);
+
+  /**
+   * Limits how far a side's command can get ahead of its measured velocity, this stops wheels from slipping when accelerating.
+   *
+   * Braking and reversing aren't limited.
+   *
+   * \param max_slip
+   *        the most a command can lead velocity by, out of 127.  0 disables
+   */
+  void assist_traction_set(double max_slip);
+
+  /**
+   * Returns the traction control limit, 0 is disabled.
+   */
+  double assist_traction_get();
+
+  /**
+   * Sets how forward and turning share power when the sticks add up to more than max speed.
+   *
+   * 1.0 keeps all of turning and takes it out of forward, 0.0 keeps all of forward, 0.5 splits it evenly.
+   * Setting this disables opcontrol_arcade_scaling on the chassis so they don't stack.
+   *
+   * \param priority
+   *        0.0 to 1.0, less than 0 disables
+   */
+  void assist_turn_priority_set(double priority);
+
+  /**
+   * Returns the turn priority, less than 0 is disabled.
+   */
+  double assist_turn_priority_get();
+
+ private:
+  Drive* drive;
+  ControllerInput* input;
+  OutputStage* outputs = nullptr;
+  bool heading_hold = false;
+  bool heading_holding = false;
+  int heading_hold_delay = 150;
+  int heading_hold_timer = 0;
+  AngularPID heading_pid;
+  double max_slip = 0.0;
+  double turn_priority = -1.0;
+  double max_rpm = 0.0;
+  double heading_hold_iterate(double fwd_stick, double turn_stick, int turn_raw);
+  double traction_limit(double command, double velocity);
+  bool curves_custom = false;
+  bool curves_built = false;
+  int curve_check_timer = 0;
+  void curves_refresh();
+  void sides_set(double left, double right);
+};
+}  // namespace ez
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "liblvgl/lvgl.h"
+#include "odometry.hpp"
+
+namespace ez {
+
+class FieldView {
+ public:
+  /**
+   * Width and height of the field drawing in pixels.
+   */
+  static constexpr int SIZE = 200;
+
+  /**
+   * Max poses drawn for the planned path.
+   */
+  static constexpr int MAX_PLAN_POINTS = 64;
+
+  /**
+   * Draws the field, the robot, the planned path and where the robot has been on the brain screen.
+   *
+   * The trail is drawn into a canvas one segment at a time and only the pixels a segment touches are redrawn.
+   * All drawing happens on its own low priority task at a capped frame rate, so it never takes time from the control tick.
+   * Poses are in inches with 0, 0 at the middle of the field.
+   *
+   * \param odometry
+   *        odometry whose pose is drawn
+   */
+  FieldView(Odometry& odometry);
+
+  /**
+   * Makes the drawing and starts the task.  The drawing is hidden until visible_set(true).
+   *
+   * \param fps
+   *        max frames per second, defaults to 10
+   */
+  void start(int fps = 10);
+
+  /**
+   * Shows or hides the drawing, ie when its blank page is opened or closed.  This is safe from any task.
+   *
+   * \param visible
+   *        true shows, false hides
+   */
+  void visible_set(bool visible);
+
+  /**
+   * Returns true if the drawing is showing.
+   */
+  bool visible_get();
+
+  /**
+   * Sets the planned path to draw.  This is copied, so it's safe from any task.
+   *
+   * \param poses
+   *        poses the robot should drive through, empty clears the path
+   */
+  void plan_set(const std::vector<pose>& poses);
+
+  /**
+   * Clears the trail on the next frame.
+   */
+  void trail_clear();
+
+ private:
+  Odometry* odometry;
+  pros::Task* task = nullptr;
+  pros::Mutex plan_mutex;
+  int period = 100;
+  std::atomic<bool> visible = false;
+  std::atomic<bool> clearing = false;
+  bool shown = false;
+  lv_obj_t* canvas = nullptr;
+  lv_obj_t* robot = nullptr;
+  lv_obj_t* path = nullptr;
+  std::array<lv_point_t, 4> robot_points;
+  std::array<lv_point_t, MAX_PLAN_POINTS> path_points;
+  std::vector<pose> plan;
+  bool plan_new = false;
+  lv_point_t trail_last = {-1, -1};
+  lv_point_t robot_last = {-1, -1};
+  double robot_angle = 0.0;
+  void task_run();
+  void background_draw();
+  void trail_draw(lv_point_t point);
+  void robot_draw(pose current);
+  void path_draw();
+};
+}  // namespace ez
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdarg>
+#include <cstdio>
+
+namespace ez {
+
+/**
+ * Fixed size string that formats like printf into its own buffer, so it never touches the heap.
+ *
+ * Text that doesn't fit is cut off and truncated() returns true.
+ *
+ * \param N
+ *        buffer size in bytes, including the ending 0
+ */
+template <std::size_t N>
+class fmt_buf {
+  static_assert(N > 1, "fmt_buf needs room for at least one character");
+
+ public:
+  fmt_buf() { clear(); }
+
+  /**
+   * Formats like printf.
+   *
+   * \param format
+   *        printf style format
+   */
+  explicit fmt_buf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    vprint(format, args);
+    va_end(args);
+  }
+
+  /**
+   * Replaces the text, formatted like printf.  Returns the length.
+   *
+   * \param format
+   *        printf style format
+   */
+  int print(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int written = vprint(format, args);
+    va_end(args);
+    return written;
+  }
+
+  /**
+   * Adds to the end of the text, formatted like printf.  Returns the length.
+   *
+   * \param format
+   *        printf style format
+   */
+  int append(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int written = vappend(format, args);
+    va_end(args);
+    return written;
+  }
+
+  /**
+   * Replaces the text, formatted like vprintf.  Returns the length.
+   */
+  int vprint(const char* format, va_list args) {
+    clear();
+    return vappend(format, args);
+  }
+
+  /**
+   * Adds to the end of the text, formatted like vprintf.  Returns the length.
+   */
+  int vappend(const char* format, va_list args) {
+    int wanted = vsnprintf(buffer.data() + length, SIZE - length, format, args);
+    if (wanted < 0) {
+      buffer[length] = '\0';
+      return length;
+    }
+    if (length + wanted >= SIZE) {
+      cut = true;
+      length = SIZE - 1;
+    } else {
+      length += wanted;
+    }
+    return length;
+  }
+
+  /**
+   * Empties the text.
+   */
+  void clear() {
+    buffer[0] = '\0';
+    length = 0;
+    cut = false;
+  }
+
+  /**
+   * Returns true if text was cut off since the last clear.
+   */
+  bool truncated() const { return cut; }
+
+  const char* c_str() const { return buffer.data(); }
+  int size() const { return length; }
+  static constexpr int capacity() { return SIZE - 1; }
+
+ private:
+  static constexpr int SIZE = N;
+  std::array<char, N> buffer;
+  int length;
+  bool cut;
+};
+}  // namespace ez
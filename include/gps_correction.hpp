@@ -0,0 +1,143 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "odometry.hpp"
+
+namespace ez {
+
+class GpsCorrection {
+ public:
+  /**
+   * Pulls odometry toward GPS fixes a little at a time.
+   *
+   * Each fix is compared to where odometry had the robot when the fix was taken, and a fraction of the difference
+   * is added to the current position.  Fixes with too much error are skipped, and a fix far from odometry is only
+   * believed once enough fixes in a row agree with it.
+   *
+   * Run iterate() on the control tick.
+   *
+   * \param port
+   *        port the GPS is plugged into
+   * \param odometry
+   *        odometry to correct
+   */
+  GpsCorrection(int port, Odometry& odometry);
+
+  /**
+   * Sets where the GPS sensor is on the robot.
+   *
+   * \param x
+   *        inches right of the center of the robot
+   * \param y
+   *        inches in front of the center of the robot
+   */
+  void offset_set(double x, double y);
+
+  /**
+   * Sets where the GPS' field is in odometry's coordinates.
+   *
+   * \param x
+   *        odometry x of the center of the field in inches
+   * \param y
+   *        odometry y of the center of the field in inches
+   * \param rotation
+   *        how far the GPS' axes are turned clockwise from odometry's in degrees, defaults to 0
+   */
+  void frame_set(double x, double y, double rotation = 0.0);
+
+  /**
+   * Sets the most error a fix can have to be used.
+   *
+   * \param inches
+   *        error the GPS reports, defaults to 1
+   */
+  void error_max_set(double inches);
+
+  /**
+   * Sets how much of the difference each fix corrects.
+   *
+   * \param gain
+   *        0 to 1, defaults to 0.1
+   */
+  void gain_set(double gain);
+
+  /**
+   * Sets what counts as a jump, ie when the GPS strip is blocked.
+   *
+   * \param inches
+   *        fixes farther than this from odometry are held back, defaults to 6
+   * \param agree_count
+   *        fixes in a row that have to agree before a jump is believed, defaults to 10
+   */
+  void jump_set(double inches, int agree_count);
+
+  /**
+   * Sets how old a fix is when it's read.
+   *
+   * \param ms
+   *        ms, defaults to 30
+   */
+  void latency_set(int ms);
+
+  /**
+   * Enables or disables correcting odometry.  Fixes are still read when disabled.
+   *
+   * \param enable
+   *        true enables, false disables
+   */
+  void enable(bool enable);
+
+  /**
+   * Returns true if odometry is being corrected.
+   */
+  bool enabled();
+
+  /**
+   * Reads the GPS and corrects odometry.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Returns the last fix in odometry's coordinates.
+   */
+  pose fix_get();
+
+  /**
+   * Returns how many fixes were used.
+   */
+  int accepted_get();
+
+  /**
+   * Returns how many fixes were skipped.
+   */
+  int rejected_get();
+
+  /**
+   * Prints the last fix and how many fixes were used.
+   */
+  void print();
+
+  /**
+   * The GPS sensor.
+   */
+  pros::Gps gps;
+
+ private:
+  Odometry* odometry;
+  pose frame = {0.0, 0.0, 0.0};
+  pose fix = {0.0, 0.0, 0.0};
+  pose jump = {0.0, 0.0, 0.0};
+  double last_x = 0.0;
+  double last_y = 0.0;
+  double error_max = 1.0;
+  double gain = 0.1;
+  double jump_distance = 6.0;
+  int jump_agree = 10;
+  int jump_count = 0;
+  int latency = 30;
+  int accepted = 0;
+  int rejected = 0;
+  bool is_enabled = true;
+};
+}  // namespace ez
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+class ImuFusion {
+ public:
+  /**
+   * Max amount of IMUs, including the chassis' IMU.
+   */
+  static constexpr int MAX_IMUS = 4;
+
+  /**
+   * Fuses the chassis' IMU with extra IMUs into one heading.
+   *
+   * Each IMU has its own scale and bias.  Every tick the IMUs' changes are averaged, weighted by how much each one has
+   * disagreed with the rest, and an IMU that jumps away from the others is left out.  A change on the chassis' IMU
+   * that the others don't see is taken as the chassis' heading being set.
+   *
+   * The fused heading is written to the chassis' IMU while the robot is still, so EZ-Template's turns follow it.
+   * With no extra IMUs this only follows the chassis' IMU.
+   *
+   * Run iterate() on the control tick.
+   *
+   * \param drive
+   *        the chassis, its IMU is the first IMU
+   */
+  ImuFusion(Drive& drive);
+
+  /**
+   * Adds an IMU.  Add them before calibrating.
+   *
+   * \param port
+   *        port the IMU is plugged into
+   */
+  void imu_add(int port);
+
+  /**
+   * Returns the amount of IMUs, including the chassis' IMU.
+   */
+  int imu_count();
+
+  /**
+   * Starts calibrating the extra IMUs without waiting.  Run this right before the chassis' IMU calibrates.
+   */
+  void calibrate_start();
+
+  /**
+   * Waits for the extra IMUs to finish calibrating, then measures each IMU's bias while the robot sits still.
+   * Returns true if every IMU calibrated.
+   *
+   * \param timeout
+   *        most time to wait for calibration in ms, defaults to 3000
+   */
+  bool calibrate_finish(int timeout = 3000);
+
+  /**
+   * Sets an IMU's scale.  The chassis' IMU is 0 and uses the chassis' IMU scaler.
+   *
+   * \param imu
+   *        which IMU, in the order they were added
+   * \param scale
+   *        factor to scale the IMU by
+   */
+  void scale_set(int imu, double scale);
+
+  /**
+   * Returns an IMU's scale.
+   *
+   * \param imu
+   *        which IMU, in the order they were added
+   */
+  double scale_get(int imu);
+
+  /**
+   * Starts measuring scales.  Turn the robot a known amount, then run scale_calibrate_end().
+   */
+  void scale_calibrate_start();
+
+  /**
+   * Sets every IMU's scale from how far it saw the robot turn since scale_calibrate_start(), and prints them.
+   *
+   * \param degrees
+   *        how far the robot actually turned, more full turns gives a better scale
+   */
+  void scale_calibrate_end(double degrees);
+
+  /**
+   * Sets how far one IMU can disagree with the others in one tick before it's left out.
+   *
+   * \param degrees
+   *        degrees per tick, defaults to 2
+   */
+  void outlier_set(double degrees);
+
+  /**
+   * Reads the IMUs and updates the heading.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Returns the fused heading in degrees, in the same frame as chassis.drive_imu_get().
+   */
+  double heading_get();
+
+  /**
+   * Returns how far the fused heading is from chassis.drive_imu_get().
+   */
+  double correction_get();
+
+  /**
+   * Returns how many IMUs were used last tick.
+   */
+  int active_get();
+
+  /**
+   * Prints each IMU's scale, bias, weight and how often it was left out.
+   */
+  void print();
+
+ private:
+  struct unit {
+    pros::Imu* imu;
+    double scale;
+    double bias;
+    double variance;
+    double last;
+    double turned;
+    double delta;
+    int rejections;
+    bool valid;
+    bool used;
+  };
+  Drive* drive;
+  std::vector<pros::Imu> extras;
+  std::array<unit, MAX_IMUS> units = {};
+  int count = 0;
+  double heading = 0.0;
+  double delta_last = 0.0;
+  double outlier = 2.0;
+  int active = 0;
+  int still_time = 0;
+  bool calibrating_scale = false;
+  bool ready = false;
+  double read(unit& current);
+};
+}  // namespace ez
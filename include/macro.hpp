@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "motion_program.hpp"
+
+namespace ez {
+
+/**
+ * Enum for what a macro's poses are relative to.
+ */
+enum macro_anchor : uint8_t { MACRO_RELATIVE = 0,  // Replays from wherever the robot is when it starts
+                              MACRO_FIELD = 1 };   // Drives to the same spots on the field every time
+
+/**
+ * One recorded pose.  Positions are in hundredths of an inch and angles in hundredths of a degree.
+ */
+struct macro_point {
+  int16_t x;
+  int16_t y;
+  int16_t theta;
+  uint8_t dir;
+  uint8_t speed;
+};
+
+/**
+ * An actuator the driver used, it runs again once replay passes its point.
+ */
+struct macro_event {
+  uint16_t point;
+  uint8_t id;
+  int8_t value;
+};
+
+/**
+ * A recorded macro.
+ */
+struct macro {
+  macro_anchor anchor = MACRO_RELATIVE;
+  uint16_t point_count = 0;
+  uint16_t event_count = 0;
+  std::array<macro_point, 256> points;
+  std::array<macro_event, 64> events;
+};
+
+class MacroRecorder {
+ public:
+  /**
+   * Max amount of macro slots.
+   */
+  static constexpr int MAX_SLOTS = 8;
+
+  /**
+   * Records driver control into macros and replays them with odometry.
+   *
+   * Actuator events replay through the runner's actuators, so they need to be registered with actuator_add.
+   *
+   * \param drive
+   *        the chassis to record and replay with
+   * \param runner
+   *        the runner replays are sent to
+   */
+  MacroRecorder(Drive& drive, MotionRunner& runner);
+
+  /**
+   * Adds named slots to record into, and loads any of them saved on the SD card.
+   *
+   * \param names
+   *        name for each slot, ie {"Mogo Grab", "Corner Clear"}
+   */
+  void slots_add(std::vector<std::string> names);
+
+  /**
+   * Selects a slot.
+   *
+   * \param slot
+   *        slot index
+   */
+  void slot_set(int slot);
+
+  /**
+   * Selects the next slot, wraps around to the first.
+   */
+  void slot_next();
+
+  /**
+   * Returns the selected slot.
+   */
+  int slot_get();
+
+  /**
+   * Returns the name of the selected slot.
+   */
+  const char* slot_name_get();
+
+  /**
+   * Returns true if the selected slot has something recorded.
+   */
+  bool slot_recorded();
+
+  /**
+   * Sets how far apart recorded poses are.
+   *
+   * \param distance
+   *        distance in inches, defaults to 4
+   */
+  void point_spacing_set(double distance);
+
+  /**
+   * Starts recording into the selected slot.  This enables odometry.
+   *
+   * \param anchor
+   *        MACRO_RELATIVE or MACRO_FIELD
+   */
+  void record_start(macro_anchor anchor = MACRO_RELATIVE);
+
+  /**
+   * Stops recording and saves the slot to the SD card.
+   */
+  void record_stop();
+
+  /**
+   * Returns true while recording.
+   */
+  bool recording();
+
+  /**
+   * Records the robot's pose.  Run this every loop in opcontrol.
+   */
+  void record_iterate();
+
+  /**
+   * Records an actuator the driver used.  Does nothing when not recording.
+   *
+   * \param id
+   *        actuator id registered with the runner
+   * \param value
+   *        value the actuator was set to, -127 to 127
+   */
+  void event(int id, int value);
+
+  /**
+   * Starts replaying the selected slot in its own task.  Returns false if the slot is empty or something is already running.
+   */
+  bool replay();
+
+  /**
+   * Returns true while a replay is running.
+   */
+  bool replaying();
+
+  /**
+   * Stops the replay and hands the drive back.
+   */
+  void replay_stop();
+
+ private:
+  Drive* drive;
+  MotionRunner* runner;
+  std::vector<std::string> names;
+  std::vector<macro> slots;
+  int slot = 0;
+  double spacing = 4.0;
+  bool is_recording = false;
+  std::atomic<bool> is_replaying = false;
+  pose start;
+  pose last;
+  drive_directions last_dir = fwd;
+  std::vector<motion_step> program;
+  void point_add(pose current, drive_directions dir);
+  pose point_to_pose(const macro_point& point, const pose& origin);
+  void program_build(const macro& input);
+  bool sd_save(int index);
+  bool sd_load(int index);
+};
+}  // namespace ez
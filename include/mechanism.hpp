@@ -0,0 +1,213 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+class Mechanism {
+ public:
+  /**
+   * Max amount of presets.
+   */
+  static constexpr int MAX_PRESETS = 8;
+
+  /**
+   * Motion profiled position control for an arm or lift.
+   *
+   * Angles are in degrees of the mechanism, after the gear ratio.  Run iterate() on the control tick.
+   * Nothing drives the motors until move_to(), move_to_angle() or manual() sends the mechanism somewhere.
+   *
+   * \param motors
+   *        motors that move the mechanism, they all get the same output
+   */
+  Mechanism(std::vector<pros::Motor> motors);
+
+  /**
+   * Motion profiled position control for an arm or lift.
+   *
+   * Angles are in degrees of the mechanism, after the gear ratio.  Run iterate() on the control tick.
+   * Nothing drives the motors until move_to(), move_to_angle() or manual() sends the mechanism somewhere.
+   *
+   * \param motor
+   *        motor that moves the mechanism
+   */
+  Mechanism(pros::Motor motor);
+
+  /**
+   * Sets the gear ratio.
+   *
+   * \param ratio
+   *        motor rotations per mechanism rotation, defaults to 1
+   */
+  void ratio_set(double ratio);
+
+  /**
+   * Sets PID constants.
+   *
+   * \param p
+   *        kP
+   * \param i
+   *        kI
+   * \param d
+   *        kD
+   * \param start_i
+   *        error value that i starts within
+   */
+  void constants_set(double p, double i = 0.0, double d = 0.0, double start_i = 0.0);
+
+  /**
+   * Sets exit conditions, these are the same as ez::PID's.
+   *
+   * \param small_exit_time
+   *        time to exit within small_error
+   * \param small_error
+   *        error in degrees the small timer starts within
+   * \param big_exit_time
+   *        time to exit within big_error
+   * \param big_error
+   *        error in degrees the big timer starts within
+   * \param velocity_exit_time
+   *        time to exit when the mechanism isn't moving
+   * \param mA_timeout
+   *        time to exit when the motor is over current
+   */
+  void exit_condition_set(int small_exit_time, double small_error, int big_exit_time = 0, double big_error = 0, int velocity_exit_time = 0, int mA_timeout = 0);
+
+  /**
+   * Sets the motion profile moves follow.
+   *
+   * \param max_velocity
+   *        fastest speed in degrees per second
+   * \param acceleration
+   *        acceleration in degrees per second squared
+   */
+  void profile_set(double max_velocity, double acceleration);
+
+  /**
+   * Sets feedforward added to the PID output.
+   *
+   * \param kg
+   *        output to hold the mechanism level against gravity, out of 127
+   * \param level_angle
+   *        angle the mechanism is level at, gravity pulls hardest here
+   * \param kv
+   *        output per degree per second of profile velocity
+   */
+  void feedforward_set(double kg, double level_angle, double kv = 0.0);
+
+  /**
+   * Sets a preset angle.
+   *
+   * \param id
+   *        preset id, 0 to MAX_PRESETS - 1
+   * \param name
+   *        name used when printing, this must be a string literal
+   * \param angle
+   *        angle in degrees
+   */
+  void preset_set(int id, const char* name, double angle);
+
+  /**
+   * Starts moving to a preset.  This doesn't wait for the move to finish.
+   *
+   * \param preset
+   *        preset id
+   */
+  void move_to(int preset);
+
+  /**
+   * Starts moving to an angle.  This doesn't wait for the move to finish.
+   *
+   * \param angle
+   *        angle in degrees
+   */
+  void move_to_angle(double angle);
+
+  /**
+   * Runs the mechanism open loop, like a joystick would.  0 holds it where it is.
+   *
+   * \param voltage
+   *        -127 to 127
+   */
+  void manual(int voltage);
+
+  /**
+   * Runs the profile and PID and sets the motors.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Returns how the last move finished, ez::RUNNING while it's still moving.
+   */
+  exit_output exit_get();
+
+  /**
+   * Blocks until the move finishes.
+   */
+  void wait();
+
+  /**
+   * Blocks until the mechanism passes an angle.
+   *
+   * \param angle
+   *        angle in degrees
+   */
+  void wait_until(double angle);
+
+  /**
+   * Returns the mechanism's angle in degrees.
+   */
+  double angle_get();
+
+  /**
+   * Returns the angle the mechanism is moving to.
+   */
+  double target_get();
+
+  /**
+   * Returns the preset the mechanism is moving to or holding, or -1 if it's at an angle that isn't a preset.
+   */
+  int preset_get();
+
+  /**
+   * Sets the current angle.  Use this when the mechanism is against a hard stop at startup.
+   *
+   * \param angle
+   *        angle in degrees, defaults to 0
+   */
+  void angle_set(double angle = 0.0);
+
+  /**
+   * PID for position control.
+   */
+  PID pid;
+
+ private:
+  struct preset {
+    const char* name;
+    double angle;
+  };
+  std::vector<pros::Motor> motors;
+  std::array<preset, MAX_PRESETS> presets = {};
+  double ratio = 1.0;
+  double max_velocity = 180.0;
+  double acceleration = 720.0;
+  double kg = 0.0;
+  double level_angle = 0.0;
+  double kv = 0.0;
+  double target = 0.0;
+  double setpoint = 0.0;
+  double setpoint_velocity = 0.0;
+  double offset = 0.0;
+  int preset_id = -1;
+  int manual_voltage = 0;
+  bool manual_active = true;  // Nothing is held until the mechanism is sent somewhere
+  bool profile_done = true;
+  exit_output exit = RUNNING;
+  void target_start(double angle);
+};
+}  // namespace ez
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <type_traits>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "odometry.hpp"
+#include "units.hpp"
+
+namespace ez {
+
+/**
+ * Enum for which axis an auton is flipped across.
+ *
+ * x negates x, this turns a red side auton into a blue side auton.
+ * y negates y, this turns a left side auton into a right side auton on the same alliance.
+ */
+enum class mirror_axis { none = 0,
+                         x = 1,
+                         y = 2 };
+
+/**
+ * Transforms that flip field coordinates across an axis.
+ *
+ * The axis is a template parameter, so every branch here is decided at compile time.
+ */
+template <mirror_axis A>
+struct mirror {
+  static constexpr double x(double input) {
+    if constexpr (A == mirror_axis::x) return -input;
+    return input;
+  }
+
+  static constexpr double y(double input) {
+    if constexpr (A == mirror_axis::y) return -input;
+    return input;
+  }
+
+  /**
+   * Flips an absolute heading, 0 is facing +y and angles increase clockwise.
+   */
+  static constexpr double angle(double input) {
+    if (input == CONSTEXPR_ANGLE_NOT_SET) return input;
+    if constexpr (A == mirror_axis::x) return -input;
+    if constexpr (A == mirror_axis::y) return 180.0 - input;
+    return input;
+  }
+
+  /**
+   * Flips a relative turn, any flip reverses which way the robot turns.
+   */
+  static constexpr double relative_angle(double input) {
+    if constexpr (A == mirror_axis::none) return input;
+    return -input;
+  }
+
+  static constexpr e_swing swing(e_swing input) {
+    if constexpr (A == mirror_axis::none) return input;
+    return input == LEFT_SWING ? RIGHT_SWING : LEFT_SWING;
+  }
+
+  static constexpr e_angle_behavior behavior(e_angle_behavior input) {
+    if constexpr (A == mirror_axis::none) return input;
+    if (input == cw) return ccw;
+    if (input == ccw) return cw;
+    return input;
+  }
+
+  /**
+   * Flips a pose, okapi units are stripped on the way.
+   */
+  template <pose_value T>
+  static constexpr pose point(const T& input) {
+    pose output = units::raw(input);
+    return {x(output.x), y(output.y), angle(output.theta)};
+  }
+
+  template <odom_value T>
+  static constexpr odom movement(const T& input) {
+    odom output = units::raw(input);
+    output.target = point(output.target);
+    output.turn_behavior = behavior(output.turn_behavior);
+    return output;
+  }
+
+  /**
+   * Flips a list of movements in place.
+   */
+  static std::vector<odom> movements(std::vector<odom> inputs) {
+    if constexpr (A != mirror_axis::none) {
+      for (auto& input : inputs)
+        input = movement(input);
+    }
+    return inputs;
+  }
+
+  /**
+   * Strips units and flips a list of movements in one pass.
+   */
+  static std::vector<odom> movements(const std::vector<united_odom>& inputs) {
+    std::vector<odom> outputs;
+    outputs.reserve(inputs.size());
+    for (const auto& input : inputs)
+      outputs.push_back(movement(input));
+    return outputs;
+  }
+
+  /**
+   * Flips trailing parameters like behaviors, everything else is passed through.
+   */
+  template <class T>
+  static constexpr T arg(T input) {
+    if constexpr (std::is_same_v<T, e_angle_behavior>)
+      return behavior(input);
+    else
+      return input;
+  }
+};
+
+/**
+ * Wrapper around Drive that flips every motion across an axis at compile time.
+ *
+ * Write an auton once for one side of the field, then run it with Mirrored<mirror_axis::none>
+ * for that side and Mirrored<mirror_axis::x> for the other alliance.  This replaces odom_x_flip and
+ * odom_y_flip, which flip globally at runtime.
+ */
+template <mirror_axis A>
+class Mirrored {
+ public:
+  using m = mirror<A>;
+
+  /**
+   * The wrapped chassis, use this for anything that isn't a motion.
+   */
+  Drive& drive;
+
+  /**
+   * Wraps a chassis.
+   *
+   * \param chassis
+   *        the chassis motions are sent to
+   */
+  Mirrored(Drive& chassis) : drive(chassis) {}
+
+  /////
+  //
+  // Odometry
+  //
+  /////
+
+  template <length_value X, length_value Y, angle_value T>
+  void odom_xyt_set(X x, Y y, T t) { ez::odom_pose_set(drive, m::point(pose{units::in(x), units::in(y), units::deg(t)})); }
+  template <length_value X, length_value Y>
+  void odom_xy_set(X x, Y y) { ez::odom_pose_set(drive, {m::x(units::in(x)), m::y(units::in(y)), ANGLE_NOT_SET}); }
+  template <angle_value T>
+  void odom_theta_set(T t) { drive.odom_theta_set(m::angle(units::deg(t))); }
+  void odom_pose_set(pose itarget) { ez::odom_pose_set(drive, m::point(itarget)); }
+  void odom_pose_set(united_pose itarget) { ez::odom_pose_set(drive, m::point(itarget)); }
+
+  /////
+  //
+  // Motions
+  //
+  // Plain numbers and okapi units share one template, units are stripped before the chassis sees them.
+  // Poses and movements keep a plain overload so braced lists like {{x, y}, fwd, 110} still work.
+  //
+  /////
+
+  template <length_value L, class... Args>
+  void pid_drive_set(L target, Args... args) { drive.pid_drive_set(units::in(target), args...); }
+
+  template <length_value L, class... Args>
+  void pid_odom_set(L target, Args... args) { drive.pid_odom_set(units::in(target), args...); }
+  template <class... Args>
+  void pid_odom_set(odom imovement, Args... args) { drive.pid_odom_set(m::movement(imovement), args...); }
+  template <class... Args>
+  void pid_odom_set(united_odom imovement, Args... args) { drive.pid_odom_set(m::movement(imovement), args...); }
+  template <class... Args>
+  void pid_odom_set(std::vector<odom> imovements, Args... args) { drive.pid_odom_set(m::movements(std::move(imovements)), args...); }
+  template <class... Args>
+  void pid_odom_set(const std::vector<united_odom>& imovements, Args... args) { drive.pid_odom_set(m::movements(imovements), args...); }
+
+  template <class... Args>
+  void pid_odom_ptp_set(odom imovement, Args... args) { drive.pid_odom_ptp_set(m::movement(imovement), args...); }
+  template <class... Args>
+  void pid_odom_ptp_set(united_odom imovement, Args... args) { drive.pid_odom_ptp_set(m::movement(imovement), args...); }
+
+  template <class... Args>
+  void pid_odom_boomerang_set(odom imovement, Args... args) { drive.pid_odom_boomerang_set(m::movement(imovement), args...); }
+  template <class... Args>
+  void pid_odom_boomerang_set(united_odom imovement, Args... args) { drive.pid_odom_boomerang_set(m::movement(imovement), args...); }
+
+  template <class... Args>
+  void pid_odom_pp_set(std::vector<odom> imovements, Args... args) { drive.pid_odom_pp_set(m::movements(std::move(imovements)), args...); }
+  template <class... Args>
+  void pid_odom_pp_set(const std::vector<united_odom>& imovements, Args... args) { drive.pid_odom_pp_set(m::movements(imovements), args...); }
+  template <class... Args>
+  void pid_odom_injected_pp_set(std::vector<odom> imovements, Args... args) { drive.pid_odom_injected_pp_set(m::movements(std::move(imovements)), args...); }
+  template <class... Args>
+  void pid_odom_injected_pp_set(const std::vector<united_odom>& imovements, Args... args) { drive.pid_odom_injected_pp_set(m::movements(imovements), args...); }
+  template <class... Args>
+  void pid_odom_smooth_pp_set(std::vector<odom> imovements, Args... args) { drive.pid_odom_smooth_pp_set(m::movements(std::move(imovements)), args...); }
+  template <class... Args>
+  void pid_odom_smooth_pp_set(const std::vector<united_odom>& imovements, Args... args) { drive.pid_odom_smooth_pp_set(m::movements(imovements), args...); }
+
+  template <angle_value T, class... Args>
+  void pid_turn_set(T target, int speed, Args... args) { drive.pid_turn_set(m::angle(units::deg(target)), speed, m::arg(args)...); }
+  template <class... Args>
+  void pid_turn_set(pose itarget, drive_directions dir, int speed, Args... args) { drive.pid_turn_set(m::point(itarget), dir, speed, m::arg(args)...); }
+  template <class... Args>
+  void pid_turn_set(united_pose itarget, drive_directions dir, int speed, Args... args) { drive.pid_turn_set(m::point(itarget), dir, speed, m::arg(args)...); }
+
+  template <angle_value T, class... Args>
+  void pid_turn_relative_set(T target, int speed, Args... args) { drive.pid_turn_relative_set(m::relative_angle(units::deg(target)), speed, m::arg(args)...); }
+
+  template <angle_value T, class... Args>
+  void pid_swing_set(e_swing type, T target, int speed, Args... args) { drive.pid_swing_set(m::swing(type), m::angle(units::deg(target)), speed, m::arg(args)...); }
+
+  template <angle_value T, class... Args>
+  void pid_swing_relative_set(e_swing type, T target, int speed, Args... args) { drive.pid_swing_relative_set(m::swing(type), m::relative_angle(units::deg(target)), speed, m::arg(args)...); }
+
+  void pid_angle_behavior_set(e_angle_behavior behavior) { drive.pid_angle_behavior_set(m::behavior(behavior)); }
+
+  /////
+  //
+  // Waits
+  //
+  /////
+
+  void pid_wait() { drive.pid_wait(); }
+  void pid_wait_quick() { drive.pid_wait_quick(); }
+  void pid_wait_quick_chain() { drive.pid_wait_quick_chain(); }
+  void pid_wait_until_index(int index) { drive.pid_wait_until_index(index); }
+  void pid_wait_until_index_started(int index) { drive.pid_wait_until_index_started(index); }
+  void pid_wait_until(okapi::QLength target) { drive.pid_wait_until(units::in(target)); }
+  void pid_wait_until(okapi::QAngle target) { drive.pid_wait_until(m::angle(units::deg(target))); }
+  void pid_wait_until(pose target) { drive.pid_wait_until(m::point(target)); }
+  void pid_wait_until(united_pose target) { drive.pid_wait_until(m::point(target)); }
+  void pid_wait_until_point(pose target) { drive.pid_wait_until_point(m::point(target)); }
+  void pid_wait_until_point(united_pose target) { drive.pid_wait_until_point(m::point(target)); }
+
+  /**
+   * Waits until a distance in drive motions, or an angle in turns and swings.
+   */
+  void pid_wait_until(double target) {
+    e_mode mode = drive.drive_mode_get();
+    bool is_angle = mode == TURN || mode == SWING || mode == TURN_TO_POINT;
+    drive.pid_wait_until(is_angle ? m::angle(target) : target);
+  }
+
+  void pid_speed_max_set(int speed) { drive.pid_speed_max_set(speed); }
+};
+}  // namespace ez
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <span>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "mirror.hpp"
+
+namespace ez {
+
+/**
+ * Enum for motion program opcodes.
+ */
+enum motion_op : uint8_t { OP_END = 0,
+                           OP_POSE_SET = 1,
+                           OP_DRIVE = 2,
+                           OP_ODOM_DRIVE = 3,
+                           OP_TURN = 4,
+                           OP_TURN_TO_POINT = 5,
+                           OP_SWING = 6,
+                           OP_ODOM_MOVE = 7,
+                           OP_ODOM_PATH = 8,
+                           OP_PATH_POINT = 9,
+                           OP_WAIT = 10,
+                           OP_WAIT_CHAIN = 11,
+                           OP_WAIT_UNTIL = 12,
+                           OP_DELAY = 13,
+                           OP_ACTUATOR = 14,
+                           OP_TRIGGER = 15,
+                           OP_WAIT_INDEX = 16,
+                           OP_SKIP_IF = 17 };
+
+/**
+ * One step of a motion program.
+ *
+ * Which fields are used depends on the opcode, see the builders in ez::motion.
+ */
+struct motion_step {
+  motion_op op = OP_END;
+  double x = 0.0;
+  double y = 0.0;
+  double theta = CONSTEXPR_ANGLE_NOT_SET;
+  int speed = 0;
+  int arg = 0;
+  int id = 0;
+  drive_directions dir = fwd;
+  e_swing swing = LEFT_SWING;
+  e_angle_behavior behavior = shortest;
+  bool behavior_set = false;
+  bool slew = false;
+  bool slew_set = false;
+  bool mirrored = false;  // True once flipped to the other alliance
+};
+
+/**
+ * Builders for motion program steps.
+ *
+ * These mirror the chassis functions they run, so a line like
+ * `chassis.pid_turn_set(90, TURN_SPEED);` becomes `motion::turn(90, TURN_SPEED)`.
+ * Plain numbers or okapi units both work, ie `motion::drive(24_in, 110)`, units are stripped at compile time.
+ */
+namespace motion {
+template <length_value X, length_value Y, angle_value T>
+constexpr motion_step pose_set(X x, Y y, T theta) {
+  return {.op = OP_POSE_SET, .x = units::in(x), .y = units::in(y), .theta = units::deg(theta)};
+}
+
+template <length_value L>
+constexpr motion_step drive(L distance, int speed) {
+  return {.op = OP_DRIVE, .x = units::in(distance), .speed = speed};
+}
+
+template <length_value L>
+constexpr motion_step drive(L distance, int speed, bool slew_on) {
+  return {.op = OP_DRIVE, .x = units::in(distance), .speed = speed, .slew = slew_on, .slew_set = true};
+}
+
+template <length_value L>
+constexpr motion_step odom_drive(L distance, int speed) {
+  return {.op = OP_ODOM_DRIVE, .x = units::in(distance), .speed = speed};
+}
+
+template <length_value L>
+constexpr motion_step odom_drive(L distance, int speed, bool slew_on) {
+  return {.op = OP_ODOM_DRIVE, .x = units::in(distance), .speed = speed, .slew = slew_on, .slew_set = true};
+}
+
+template <angle_value T>
+constexpr motion_step turn(T theta, int speed) {
+  return {.op = OP_TURN, .theta = units::deg(theta), .speed = speed};
+}
+
+template <angle_value T>
+constexpr motion_step turn(T theta, int speed, e_angle_behavior behavior) {
+  return {.op = OP_TURN, .theta = units::deg(theta), .speed = speed, .behavior = behavior, .behavior_set = true};
+}
+
+template <length_value X, length_value Y>
+constexpr motion_step turn_to_point(X x, Y y, drive_directions dir, int speed) {
+  return {.op = OP_TURN_TO_POINT, .x = units::in(x), .y = units::in(y), .speed = speed, .dir = dir};
+}
+
+template <angle_value T>
+constexpr motion_step swing(e_swing type, T theta, int speed, int opposite_speed = 0) {
+  return {.op = OP_SWING, .theta = units::deg(theta), .speed = speed, .arg = opposite_speed, .swing = type};
+}
+
+template <length_value X, length_value Y>
+constexpr motion_step odom_move(X x, Y y, drive_directions dir, int speed) {
+  return {.op = OP_ODOM_MOVE, .x = units::in(x), .y = units::in(y), .speed = speed, .dir = dir};
+}
+
+template <length_value X, length_value Y, angle_value T>
+constexpr motion_step odom_move(X x, Y y, T theta, drive_directions dir, int speed) {
+  return {.op = OP_ODOM_MOVE, .x = units::in(x), .y = units::in(y), .theta = units::deg(theta), .speed = speed, .dir = dir};
+}
+
+constexpr motion_step odom_path(int points, bool slew_on = false) {
+  return {.op = OP_ODOM_PATH, .arg = points, .slew = slew_on, .slew_set = true};
+}
+
+template <length_value X, length_value Y>
+constexpr motion_step path_point(X x, Y y, drive_directions dir, int speed) {
+  return {.op = OP_PATH_POINT, .x = units::in(x), .y = units::in(y), .speed = speed, .dir = dir};
+}
+
+constexpr motion_step wait() { return {.op = OP_WAIT}; }
+
+constexpr motion_step wait_chain() { return {.op = OP_WAIT_CHAIN}; }
+
+/**
+ * Waits until a distance in drive motions, or an angle in turns and swings.
+ */
+template <class T>
+  requires length_value<T> || angle_value<T>
+constexpr motion_step wait_until(T target) {
+  if constexpr (std::is_same_v<T, okapi::QAngle>)
+    return {.op = OP_WAIT_UNTIL, .x = units::deg(target)};
+  else
+    return {.op = OP_WAIT_UNTIL, .x = units::in(target)};
+}
+
+constexpr motion_step wait_until_index(int index) {
+  return {.op = OP_WAIT_INDEX, .arg = index};
+}
+
+template <time_value T>
+constexpr motion_step delay(T time) { return {.op = OP_DELAY, .arg = (int)(units::ms(time) + 0.5)}; }
+
+constexpr motion_step actuator(int id, int value) {
+  return {.op = OP_ACTUATOR, .arg = value, .id = id};
+}
+
+constexpr motion_step trigger(int id, int timeout) {
+  return {.op = OP_TRIGGER, .arg = timeout, .id = id};
+}
+
+constexpr motion_step skip_if(int trigger_id, int count) {
+  return {.op = OP_SKIP_IF, .arg = count, .id = trigger_id};
+}
+
+constexpr motion_step end() { return {.op = OP_END}; }
+
+/**
+ * Moves a turn_to_point or odom_move target onto the nearest detected field element when the step runs.
+ *
+ * \param step
+ *        turn_to_point or odom_move step
+ * \param kind
+ *        kind of element, passed to the runner's snap function
+ * \param radius
+ *        farthest to snap in inches
+ */
+constexpr motion_step snap(motion_step step, int kind, int radius) {
+  step.id = kind + 1;
+  step.arg = radius;
+  return step;
+}
+}  // namespace motion
+
+/**
+ * Returns a step flipped across an axis.  Flipping across x turns a red side step into a blue side step.
+ *
+ * \param step
+ *        the step to flip
+ */
+template <mirror_axis A>
+constexpr motion_step motion_mirror(motion_step step) {
+  using m = mirror<A>;
+  switch (step.op) {
+    case OP_POSE_SET:
+    case OP_TURN_TO_POINT:
+    case OP_ODOM_MOVE:
+    case OP_PATH_POINT:
+      step.x = m::x(step.x);
+      step.y = m::y(step.y);
+      break;
+    default:
+      break;
+  }
+  switch (step.op) {
+    case OP_POSE_SET:
+    case OP_TURN:
+    case OP_SWING:
+    case OP_ODOM_MOVE:
+    case OP_PATH_POINT:
+      step.theta = m::angle(step.theta);
+      break;
+    default:
+      break;
+  }
+  step.swing = m::swing(step.swing);
+  step.behavior = m::behavior(step.behavior);
+  if constexpr (A == mirror_axis::x)
+    step.mirrored = !step.mirrored;
+  return step;
+}
+
+/**
+ * Returns a whole program flipped across an axis.  This is evaluated at compile time for constexpr programs.
+ *
+ * \param program
+ *        the program to flip
+ */
+template <mirror_axis A, std::size_t N>
+constexpr std::array<motion_step, N> motion_mirror(const std::array<motion_step, N>& program) {
+  std::array<motion_step, N> output{};
+  for (std::size_t i = 0; i < N; i++)
+    output[i] = motion_mirror<A>(program[i]);
+  return output;
+}
+
+class MotionRunner {
+ public:
+  /**
+   * Max amount of actuators and triggers that can be registered.
+   */
+  static constexpr int MAX_IDS = 16;
+
+  /**
+   * Motion program interpreter.
+   *
+   * \param drive
+   *        the chassis motions are sent to
+   */
+  MotionRunner(Drive& drive);
+
+  /**
+   * Registers an actuator that OP_ACTUATOR steps can call.
+   *
+   * \param id
+   *        id used in the program, 0 to MAX_IDS - 1
+   * \param actuator
+   *        function given the step value and if the step was mirrored
+   */
+  void actuator_add(int id, std::function<void(int value, bool mirrored)> actuator);
+
+  /**
+   * Registers a condition that OP_TRIGGER steps wait on.
+   *
+   * \param id
+   *        id used in the program, 0 to MAX_IDS - 1
+   * \param condition
+   *        function that returns true once the program can continue
+   */
+  void trigger_add(int id, std::function<bool()> condition);
+
+  /**
+   * Sets what motion::snap() steps use to find field elements.
+   *
+   * \param snap
+   *        function given the kind, if the step was mirrored and the radius, that moves x and y onto an element and returns true if it found one
+   */
+  void snap_set(std::function<bool(int kind, bool mirrored, double radius, double& x, double& y)> snap);
+
+  /**
+   * Checks a program before it runs.  Returns -1 if the program is valid, otherwise the index of the first bad step.
+   *
+   * \param program
+   *        the program to check
+   * \param print = true
+   *        prints why a step is bad
+   */
+  int validate(std::span<const motion_step> program, bool print = true);
+
+  /**
+   * Validates then runs a program until OP_END or the end of the program.  Returns false if the program is not valid or was stopped.
+   *
+   * If this program was planned with plan(), validation is skipped and paths run from their injected and smoothed points.
+   * Once a skip_if skips or a snap moves a target the plan no longer matches, so later paths are built as they start.
+   *
+   * \param program
+   *        the program to run
+   */
+  bool run(std::span<const motion_step> program);
+
+  /**
+   * Returns the index of the step that's running, or -1 if no program is running.
+   */
+  int step_get();
+
+  /**
+   * Stops the program that's running from another task.  The current motion is cancelled and no more steps run.
+   */
+  void stop();
+
+  /**
+   * Dry runs a program without moving the robot.  Returns false if the program is not valid.
+   *
+   * The pose the robot should be at after each step is saved for previewing, ie on the field view.
+   * Paths after a pose_set step are injected and smoothed from their planned start and kept for run(),
+   * so autonomous doesn't build them on the clock.  This plans as if no skip_if skips.
+   *
+   * \param program
+   *        the program to plan
+   */
+  bool plan(std::span<const motion_step> program);
+
+  /**
+   * Returns true if this program is the one that's planned.
+   *
+   * \param program
+   *        the program to check
+   */
+  bool planned(std::span<const motion_step> program);
+
+  /**
+   * Forgets the planned program.
+   */
+  void plan_clear();
+
+  /**
+   * Returns the pose the robot should be at after each step of the planned program.
+   */
+  const std::vector<pose>& plan_poses_get();
+
+  /**
+   * Returns how far the robot will drive in the planned program, in inches.
+   */
+  double plan_distance_get();
+
+  /**
+   * Prints the planned program to the terminal.
+   */
+  void plan_print();
+
+  /**
+   * Loads a program from the SD card.  Returns false if the file can't be read or a line can't be parsed.
+   *
+   * Each line is a builder name followed by its parameters, ie `turn_to_point -28.9 21.1 rev 63`.
+   *
+   * \param path
+   *        file on the SD card, ie "/usd/red_left.txt"
+   * \param program
+   *        loaded steps are written here
+   */
+  bool sd_load(std::string path, std::vector<motion_step>& program);
+
+ private:
+  Drive* drive;
+  std::array<std::function<void(int, bool)>, MAX_IDS> actuators;
+  std::array<std::function<bool()>, MAX_IDS> triggers;
+  std::function<bool(int, bool, double, double&, double&)> snapper;
+  pose target_get(const motion_step& step);
+  std::vector<odom> path_buffer;
+  struct planned_path {
+    std::vector<odom> points;
+    std::vector<int> indexes;  // Where each of the program's points landed in points
+  };
+  std::atomic<bool> stopping = false;
+  std::atomic<int> current_step = -1;
+  void step_run(const motion_step& step);
+  void path_build(std::span<const motion_step> program, std::size_t index, std::vector<odom>& output);
+  void path_prepare(pose start, planned_path& path);
+  std::span<const motion_step> planned_program;
+  std::vector<planned_path> planned_paths;
+  bool off_plan = false;
+  std::vector<pose> planned_poses;
+  double planned_distance = 0.0;
+};
+}  // namespace ez
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+/**
+ * Returns the free speed of a motor's cartridge in rpm.
+ *
+ * \param motor
+ *        the motor to check
+ */
+double motor_rpm_max(const pros::Motor& motor);
+
+/**
+ * Returns the free speed of the drive motors' cartridge in rpm.
+ *
+ * \param drive
+ *        the chassis to check
+ */
+double drive_rpm_max(Drive& drive);
+}  // namespace ez
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "imu_fusion.hpp"
+#include "portable.hpp"
+
+namespace ez {
+
+/**
+ * Reads a tracking wheel as whole ticks.
+ */
+class tick_counter {
+ public:
+  /**
+   * Reads a tracking wheel as whole ticks, so deltas never pick up rounding from a growing total.
+   *
+   * \param tracker
+   *        tracking wheel to read, nullptr means unused
+   */
+  tick_counter(tracking_wheel* tracker = nullptr);
+
+  /**
+   * Sets the tracking wheel and starts counting from its current reading.
+   *
+   * \param tracker
+   *        tracking wheel to read, nullptr means unused
+   */
+  void tracker_set(tracking_wheel* tracker);
+
+  /**
+   * Returns the tracking wheel, or nullptr if it's unused.
+   */
+  tracking_wheel* tracker_get();
+
+  /**
+   * Returns ticks since the last call.  The sensor wrapping past the end of an int32 is handled.
+   */
+  int32_t delta_get();
+
+  /**
+   * Returns ticks counted since the tracker was set.
+   */
+  int64_t total_get();
+
+  /**
+   * Converts ticks from this tracking wheel to inches.
+   *
+   * \param ticks
+   *        ticks to convert
+   */
+  double inches(int64_t ticks);
+
+  /**
+   * Starts counting from the current reading.
+   */
+  void reset();
+
+ private:
+  tracking_wheel* tracker;
+  uint32_t last = 0;
+  int64_t total = 0;
+  uint32_t raw_get();
+};
+
+class Odometry {
+ public:
+  /**
+   * Amount of ticks of position history kept.
+   */
+  static constexpr int HISTORY_SIZE = 64;
+
+  /**
+   * Tracks position from tracking wheel ticks, alongside the chassis' own tracking.
+   *
+   * Ticks are summed as integers and the position with compensated sums, so it doesn't lose precision as a long run adds up.
+   * Heading inside each tick follows the gyro rate, so fast swings and turns don't cut corners.
+   * EZ-Template's task keeps tracking for its motions, this never writes the chassis on a tick so the two can't race.
+   * Pose sets and corrections reach both, set the position with pose_set(), xy_set() or ez::odom_pose_set().
+   *
+   * Run iterate() on the control tick.
+   *
+   * \param drive
+   *        the chassis to track
+   */
+  Odometry(Drive& drive);
+
+  /**
+   * Reads the chassis' tracking wheels.  Run this after the odom_tracker_*_set() calls.
+   */
+  void trackers_update();
+
+  /**
+   * Enables or disables tracking.
+   *
+   * \param enable
+   *        true enables, false disables
+   */
+  void enable(bool enable);
+
+  /**
+   * Returns true if tracking is enabled.
+   */
+  bool enabled();
+
+  /**
+   * Uses a fused heading instead of the chassis' heading.
+   *
+   * \param fusion
+   *        IMU fusion for the chassis
+   */
+  void imu_fusion_set(ImuFusion& fusion);
+
+  /**
+   * Enables or disables using the IMU's gyro rate between ticks.  When disabled, each tick turns at a constant rate.
+   *
+   * \param enable
+   *        true enables, false disables
+   */
+  void gyro_enable(bool enable);
+
+  /**
+   * Returns true if the IMU's gyro rate is used between ticks.
+   */
+  bool gyro_enabled();
+
+  /**
+   * Reads the trackers and updates the position.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Returns the position in inches and degrees, in the same frame as chassis.odom_pose_get().
+   */
+  pose pose_get();
+
+  /**
+   * Sets the position here and on the chassis.  This is safe from any task, the next iterate() starts from it.
+   *
+   * \param x
+   *        x in inches
+   * \param y
+   *        y in inches
+   */
+  void xy_set(double x, double y);
+
+  /**
+   * Sets the position and heading here and on the chassis.  This is safe from any task, the next iterate() starts from it.
+   *
+   * \param target
+   *        pose in inches and degrees, the heading is left alone if it's ANGLE_NOT_SET
+   */
+  void pose_set(pose target);
+
+  /**
+   * Returns the odometry tracking a chassis, or nullptr if there isn't one.
+   *
+   * \param drive
+   *        the chassis
+   */
+  static Odometry* find(Drive& drive);
+
+  /**
+   * Moves the position by a correction, ie from another sensor.  The chassis is moved now, this on the next iterate().
+   *
+   * \param x
+   *        inches to move in x
+   * \param y
+   *        inches to move in y
+   */
+  void correct(double x, double y);
+
+  /**
+   * Finds where the robot was at a time in the last HISTORY_SIZE ticks, moved by every correction made since.
+   * Returns false if the time isn't in the history.
+   *
+   * \param time
+   *        ms since the program started
+   * \param output
+   *        position at that time, in the same frame as pose_get()
+   */
+  bool pose_at(uint32_t time, pose& output);
+
+  /**
+   * Prints the position and tick totals to the terminal.
+   */
+  void print();
+
+ private:
+  Drive* drive;
+  ImuFusion* fusion = nullptr;
+  // Left, right, front, back, the same order as the chassis' trackers
+  std::array<tick_counter, 4> counters;
+  kahan_sum x;
+  kahan_sum y;
+  double theta_last = 0.0;
+  double rate_last = 0.0;
+  double theta_read_last = 0.0;
+  double gyro_correlation = 0.0;
+  uint64_t time_last = 0;
+  uint64_t sample_time = 0;
+  bool is_gyro_enabled = true;
+  pros::Mutex set_mutex;
+  bool set_pending = false;
+  double set_x = 0.0;
+  double set_y = 0.0;
+  struct history_entry {
+    uint32_t time;
+    pose position;
+  };
+  std::array<history_entry, HISTORY_SIZE> history = {};
+  int history_count = 0;
+  double correction_x = 0.0;
+  double correction_y = 0.0;
+  bool is_enabled = true;
+  bool started = false;
+  double sign_x();
+  double sign_y();
+  double theta_get();
+  double heading_now(uint64_t now, double& rate);
+  void adopt();
+  bool history_find(uint32_t time, pose& output);
+};
+
+/**
+ * Sets a chassis' pose through the Odometry tracking it, or straight on the chassis if there isn't one.
+ *
+ * \param drive
+ *        the chassis
+ * \param target
+ *        pose in inches and degrees, the heading is left alone if it's ANGLE_NOT_SET
+ */
+void odom_pose_set(Drive& drive, pose target);
+}  // namespace ez
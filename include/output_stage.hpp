@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+class OutputStage {
+ public:
+  /**
+   * Max amount of motors that can be added, drive motors included.
+   */
+  static constexpr int MAX_MOTORS = 24;
+
+  /**
+   * Max amount of pistons that can be added.
+   */
+  static constexpr int MAX_PISTONS = 16;
+
+  /**
+   * Collects every motor and piston command for a loop and sends them together with flush().
+   *
+   * Commands that didn't change since they were last sent are skipped.
+   */
+  OutputStage();
+
+  /**
+   * Adds every drive motor.  drive_set() commands these, skipping motors that are in a PTO.
+   *
+   * \param drive
+   *        the chassis to add
+   */
+  void drive_add(Drive& drive);
+
+  /**
+   * Adds a motor.
+   *
+   * \param motor
+   *        the motor to add
+   */
+  void motor_add(pros::Motor& motor);
+
+  /**
+   * Adds a piston.
+   *
+   * \param piston
+   *        the piston to add
+   */
+  void piston_add(pros::adi::DigitalOut& piston);
+
+  /**
+   * Queues voltage for both sides of the drive.  Motors in a PTO are skipped.
+   *
+   * This follows opcontrol_drive_reverse like the chassis does.
+   *
+   * \param left
+   *        voltage for left side, -127 to 127
+   * \param right
+   *        voltage for right side, -127 to 127
+   */
+  void drive_set(int left, int right);
+
+  /**
+   * Queues voltage for a motor.
+   *
+   * \param motor
+   *        a motor added with motor_add
+   * \param voltage
+   *        -127 to 127
+   */
+  void motor_set(pros::Motor& motor, int voltage);
+
+  /**
+   * Queues a piston state.
+   *
+   * \param piston
+   *        a piston added with piston_add
+   * \param state
+   *        true is out, false is in
+   */
+  void piston_set(pros::adi::DigitalOut& piston, bool state);
+
+  /**
+   * Sends every queued command that changed.  Run this once at the end of every loop.
+   */
+  void flush();
+
+  /**
+   * Forgets what was last sent so flush() sends everything.  Use this after something else moved the outputs, like an auton.
+   */
+  void invalidate();
+
+  /**
+   * Rebuilds which drive motors are in a PTO from the chassis.  flush() does this when the chassis PTO list changes size.
+   */
+  void pto_update();
+
+  /**
+   * Sets which drive motors are in a PTO.  Motors in a PTO aren't sent anything, and motors that switched are sent their next command no matter what.
+   *
+   * \param ports
+   *        bitmask of ports, port 1 is bit 1
+   */
+  void pto_ports_set(uint32_t ports);
+
+ private:
+  static constexpr int16_t NOT_SENT = INT16_MIN;
+  struct motor_channel {
+    pros::Motor* motor;
+    int16_t command;
+    int16_t sent;
+  };
+  struct piston_channel {
+    pros::adi::DigitalOut* piston;
+    int8_t command;  // -1 until piston_set is called
+    int8_t sent;
+  };
+  Drive* drive = nullptr;
+  std::array<motor_channel, MAX_MOTORS> motors;
+  std::array<piston_channel, MAX_PISTONS> pistons;
+  std::array<int8_t, 22> port_to_channel;
+  int motor_count = 0;
+  int piston_count = 0;
+  uint32_t left_mask = 0;
+  uint32_t right_mask = 0;
+  uint32_t pto_mask = 0;
+  std::size_t pto_size = 0;
+  int channel_add(pros::Motor& motor);
+};
+}  // namespace ez
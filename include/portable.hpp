@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Helpers that don't touch PROS or the brain, so they can be tested on a computer with tests/.
+ */
+namespace ez {
+
+/**
+ * Sum that keeps the low bits lost when adding small numbers to a big total.
+ */
+struct kahan_sum {
+  double sum = 0.0;
+  double carry = 0.0;
+
+  /**
+   * Adds to the sum.
+   *
+   * \param input
+   *        value to add
+   */
+  void add(double input) {
+    double corrected = input - carry;
+    double next = sum + corrected;
+    carry = (next - sum) - corrected;
+    sum = next;
+  }
+
+  /**
+   * Sets the sum and clears the carry.
+   *
+   * \param input
+   *        new sum
+   */
+  void reset(double input = 0.0) {
+    sum = input;
+    carry = 0.0;
+  }
+};
+
+/**
+ * Returns ticks between two raw sensor readings.  Unsigned subtraction wraps, so this is right even when the sensor rolls over.
+ *
+ * \param raw
+ *        new reading
+ * \param last
+ *        last reading
+ */
+inline int32_t tick_delta(uint32_t raw, uint32_t last) { return (int32_t)(raw - last); }
+
+/**
+ * Returns the CRC-16/CCITT-FALSE of some bytes.
+ *
+ * \param data
+ *        bytes to check
+ * \param length
+ *        amount of bytes
+ */
+inline uint16_t crc16(const uint8_t* data, int length) {
+  uint16_t crc = 0xFFFF;
+  for (int i = 0; i < length; i++) {
+    crc ^= data[i] << 8;
+    for (int bit = 0; bit < 8; bit++)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+/**
+ * COBS encodes bytes, this takes out every 0 so 0 can mark where frames end.  Returns the encoded length.
+ *
+ * \param input
+ *        bytes to encode
+ * \param length
+ *        amount of bytes
+ * \param output
+ *        encoded bytes, this needs room for length + length / 254 + 1
+ */
+inline int cobs_encode(const uint8_t* input, int length, uint8_t* output) {
+  int code_index = 0, out = 1;
+  uint8_t code = 1;
+  for (int i = 0; i < length; i++) {
+    if (input[i] != 0) {
+      output[out++] = input[i];
+      code++;
+    }
+    // A full block only starts a new one if there's more to encode
+    if (input[i] == 0 || (code == 0xFF && i + 1 < length)) {
+      output[code_index] = code;
+      code_index = out++;
+      code = 1;
+    }
+  }
+  output[code_index] = code;
+  return out;
+}
+
+/**
+ * Decodes COBS encoded bytes, without the 0 that ends the frame.  Returns the decoded length, or -1 if the frame is malformed.
+ *
+ * \param input
+ *        encoded bytes
+ * \param length
+ *        amount of encoded bytes
+ * \param output
+ *        decoded bytes, this needs room for length
+ */
+inline int cobs_decode(const uint8_t* input, int length, uint8_t* output) {
+  int in = 0, out = 0;
+  while (in < length) {
+    uint8_t code = input[in++];
+    if (code == 0 || in + code - 1 > length) return -1;
+    for (int i = 1; i < code; i++)
+      output[out++] = input[in++];
+    if (code != 0xFF && in < length) output[out++] = 0;
+  }
+  return out;
+}
+
+/**
+ * Type, sequence and CRC around a frame's payload.
+ */
+constexpr int FRAME_OVERHEAD = 4;
+
+/**
+ * Builds a frame of a type, sequence number, payload and CRC-16, COBS encoded and ended with a 0.
+ * Returns the frame's length, or -1 if the payload is longer than MAX_PAYLOAD.
+ *
+ * \param type
+ *        message type
+ * \param sequence
+ *        sequence number
+ * \param data
+ *        payload
+ * \param length
+ *        payload length
+ * \param output
+ *        frame, this needs room for length + FRAME_OVERHEAD + (length + FRAME_OVERHEAD) / 254 + 2
+ */
+template <int MAX_PAYLOAD>
+int frame_encode(uint8_t type, uint8_t sequence, const void* data, int length, uint8_t* output) {
+  if (length < 0 || length > MAX_PAYLOAD) return -1;
+  uint8_t raw[MAX_PAYLOAD + FRAME_OVERHEAD];
+  raw[0] = type;
+  raw[1] = sequence;
+  if (length > 0) memcpy(raw + 2, data, length);
+  uint16_t crc = crc16(raw, length + 2);
+  raw[length + 2] = crc >> 8;
+  raw[length + 3] = crc & 0xFF;
+  int encoded_length = cobs_encode(raw, length + FRAME_OVERHEAD, output);
+  output[encoded_length++] = 0;
+  return encoded_length;
+}
+
+/**
+ * Decodes a frame, without the 0 that ends it.  Returns the decoded length with the type, sequence and CRC,
+ * or -1 if the frame is malformed or the CRC doesn't match.  The payload starts at output + 2.
+ *
+ * \param encoded
+ *        encoded bytes
+ * \param length
+ *        amount of encoded bytes
+ * \param output
+ *        decoded bytes, this needs room for length
+ */
+inline int frame_decode(const uint8_t* encoded, int length, uint8_t* output) {
+  int raw_length = cobs_decode(encoded, length, output);
+  if (raw_length < FRAME_OVERHEAD || crc16(output, raw_length - 2) != ((output[raw_length - 2] << 8) | output[raw_length - 1]))
+    return -1;
+  return raw_length;
+}
+
+/**
+ * Gathers bytes off the wire into frames, a 0 ends each one.
+ */
+template <int N>
+struct frame_collector {
+  std::array<uint8_t, N> data;
+  int length = 0;
+
+  /**
+   * Adds a byte.  Returns the frame's length in data once a 0 ends it, 0 while it's still coming in,
+   * or -1 if it was too long to be a frame.
+   *
+   * \param byte
+   *        byte off the wire
+   */
+  int add(uint8_t byte) {
+    if (byte == 0) {
+      int output = length > N ? -1 : length;
+      length = 0;
+      return output;
+    }
+    // Too long to be a frame, drop bytes until the next 0
+    if (length < N)
+      data[length++] = byte;
+    else
+      length = N + 1;
+    return 0;
+  }
+};
+
+/**
+ * Byte ring buffer that takes whole writes or nothing, so a frame is never cut in half.
+ */
+template <int N>
+struct byte_ring {
+  std::array<uint8_t, N> data;
+  int head = 0;
+  int tail = 0;
+
+  /**
+   * Returns bytes waiting to be read.
+   */
+  int used() const { return (head - tail + N) % N; }
+
+  /**
+   * Returns bytes that can be written, one slot is kept empty to tell full from empty.
+   */
+  int free() const { return N - 1 - used(); }
+
+  /**
+   * Writes all of the bytes.  Returns false and writes nothing if they don't fit.
+   *
+   * \param input
+   *        bytes to write
+   * \param length
+   *        amount of bytes
+   */
+  bool push(const uint8_t* input, int length) {
+    if (length > free()) return false;
+    for (int i = 0; i < length; i++) {
+      data[head] = input[i];
+      head = (head + 1) % N;
+    }
+    return true;
+  }
+
+  /**
+   * Returns how many bytes can be read from data + tail before wrapping around.
+   */
+  int contiguous() const { return head >= tail ? head - tail : N - tail; }
+
+  /**
+   * Drops bytes that have been read.
+   *
+   * \param length
+   *        amount of bytes read
+   */
+  void pop(int length) { tail = (tail + length) % N; }
+};
+}  // namespace ez
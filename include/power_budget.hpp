@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "pto.hpp"
+
+namespace ez {
+
+/**
+ * Enum for which motors get the most current.
+ */
+enum budget_priority : uint8_t { BUDGET_BALANCED = 0,
+                                 BUDGET_DRIVE = 1,   // Pushing and driving across the field
+                                 BUDGET_INTAKE = 2,  // Scoring with the intake
+                                 BUDGET_ARM = 3 };   // Wall stakes and hang
+
+/**
+ * Enum for what a motor is part of.
+ */
+enum budget_group : uint8_t { GROUP_DRIVE = 0,
+                              GROUP_INTAKE = 1,
+                              GROUP_ARM = 2 };
+
+class PowerBudget {
+ public:
+  /**
+   * Max amount of motors the budget can manage.
+   */
+  static constexpr int MAX_MOTORS = 12;
+
+  /**
+   * Temperature in C that motors start throttling themselves at.
+   */
+  static constexpr double THROTTLE_TEMP = 55.0;
+
+  /**
+   * Splits a total current budget between motors by priority, and lowers limits on motors that are heating up.
+   *
+   * Motors only keep a little more than they're drawing, what idle motors don't need goes to the rest.
+   *
+   * Drive motors lent to a mechanism by the PTO manager are budgeted as part of the arm, and never get more than their group's mechanism current.
+   * The drive motors left behind get the lent motors' share, so the drive keeps as much current, and torque, as the caps allow.
+   *
+   * \param drive
+   *        the chassis
+   * \param pto
+   *        PTO manager for the chassis
+   */
+  PowerBudget(Drive& drive, PtoManager& pto);
+
+  /**
+   * Adds every drive motor.
+   */
+  void drive_add();
+
+  /**
+   * Adds a motor.
+   *
+   * \param motor
+   *        the motor to add
+   * \param group
+   *        ez::GROUP_DRIVE, ez::GROUP_INTAKE or ez::GROUP_ARM
+   */
+  void motor_add(pros::Motor& motor, budget_group group);
+
+  /**
+   * Sets the total current split between every motor.  Keep this below the motors' 2500mA caps added up, or priority has nothing to move around.
+   *
+   * \param mA
+   *        total current in mA, defaults to 18000
+   */
+  void total_set(int mA);
+
+  /**
+   * Sets which motors get the most current.
+   *
+   * \param priority
+   *        ez::BUDGET_BALANCED, ez::BUDGET_DRIVE, ez::BUDGET_INTAKE or ez::BUDGET_ARM
+   */
+  void priority_set(budget_priority priority);
+
+  /**
+   * Returns which motors get the most current.
+   */
+  budget_priority priority_get();
+
+  /**
+   * Sets how far ahead throttling is predicted.  Motors predicted to throttle sooner than this get less current.
+   *
+   * \param seconds
+   *        time in seconds, defaults to 60
+   */
+  void thermal_horizon_set(double seconds);
+
+  /**
+   * Reads every motor and updates current limits.  Run this on the control tick, every 100ms is plenty.
+   */
+  void iterate();
+
+  /**
+   * Returns the current limit given to a motor in mA, or -1 if it isn't managed.
+   *
+   * \param port
+   *        motor port, the sign doesn't matter
+   */
+  int limit_get(int port);
+
+  /**
+   * Returns how many seconds until a motor is predicted to throttle, or -1 if it's cooling or holding steady.
+   *
+   * \param port
+   *        motor port, the sign doesn't matter
+   */
+  double time_to_throttle_get(int port);
+
+  /**
+   * Returns true if any motor is predicted to throttle within the thermal horizon.
+   */
+  bool throttle_predicted();
+
+  /**
+   * Prints every motor's temperature, current and limit to the terminal.
+   */
+  void print();
+
+ private:
+  struct budget_motor {
+    pros::Motor* motor;
+    budget_group group;
+    int limit;
+    int current;
+    double temperature;
+    double slope;  // C per second
+    double time_to_throttle;
+    bool warned;
+  };
+  Drive* drive;
+  PtoManager* pto;
+  std::array<budget_motor, MAX_MOTORS> motors;
+  int motor_count = 0;
+  int total = 18000;
+  budget_priority priority = BUDGET_BALANCED;
+  double horizon = 60.0;
+  uint32_t last_time = 0;
+  uint32_t pto_ports = 0;
+  budget_motor* motor_find(int port);
+};
+}  // namespace ez
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "output_stage.hpp"
+
+namespace ez {
+
+/**
+ * Enum for what a group of PTO motors is powering.
+ */
+enum pto_role : uint8_t { PTO_DRIVE = 0,
+                          PTO_MECHANISM = 1 };
+
+class PtoManager {
+ public:
+  /**
+   * Max amount of PTO groups.
+   */
+  static constexpr int MAX_GROUPS = 4;
+
+  /**
+   * Max amount of motors in a PTO group.
+   */
+  static constexpr int MAX_GROUP_MOTORS = 4;
+
+  /**
+   * Switches drive motors between the drive and a mechanism.
+   *
+   * PTO motors are kept as a bitmask of ports, and the chassis' pto_active list is kept in sync so EZ-Template skips them too.
+   * Switching never allocates.
+   *
+   * \param drive
+   *        the chassis the motors are part of
+   */
+  PtoManager(Drive& drive);
+
+  /**
+   * Adds a group of drive motors that switch together.  Returns the group's id, or -1 if it can't be added.
+   *
+   * The first motor on each side can't be used, the chassis uses it for autonomous.
+   *
+   * \param ports
+   *        ports of drive motors in the group, the same signs the chassis was made with
+   * \param piston
+   *        the piston that shifts the PTO
+   * \param mechanism_current
+   *        current limit in mA while powering the mechanism
+   * \param mechanism_brake
+   *        brake mode while powering the mechanism
+   */
+  int group_add(std::initializer_list<int> ports, pros::adi::DigitalOut& piston, int mechanism_current = 2500, pros::motor_brake_mode_e_t mechanism_brake = pros::E_MOTOR_BRAKE_HOLD);
+
+  /**
+   * Switches a group to the drive or a mechanism.  The piston, current limits and brake mode are set with it.
+   *
+   * \param group
+   *        id from group_add
+   * \param role
+   *        ez::PTO_DRIVE or ez::PTO_MECHANISM
+   */
+  void role_set(int group, pto_role role);
+
+  /**
+   * Returns what a group is powering.
+   *
+   * \param group
+   *        id from group_add
+   */
+  pto_role role_get(int group);
+
+  /**
+   * Runs every motor in a group.  Does nothing while the group is powering the drive.
+   *
+   * \param group
+   *        id from group_add
+   * \param voltage
+   *        -127 to 127
+   */
+  void group_move(int group, int voltage);
+
+  /**
+   * Returns true if the motor on this port is powering a mechanism.
+   *
+   * \param port
+   *        motor port, the sign doesn't matter
+   */
+  bool pto_check(int port) const { return ports & (1u << abs(port)); }
+
+  /**
+   * Returns every port powering a mechanism as a bitmask, port 1 is bit 1.
+   */
+  uint32_t ports_get() const { return ports; }
+
+  /**
+   * Returns how many drive motors are powering the drive.
+   */
+  int drive_motors_active();
+
+  /**
+   * Returns how much of the drive's torque is left with the PTO motors gone, 0.0 to 1.0.
+   */
+  double drive_torque_fraction();
+
+  /**
+   * Returns the current limit in mA for a motor powering a mechanism, or -1 if it's powering the drive.
+   *
+   * \param port
+   *        motor port, the sign doesn't matter
+   */
+  int mechanism_current_get(int port);
+
+  /**
+   * Keeps an output stage's PTO motors in sync with role changes.
+   *
+   * \param outputs
+   *        output stage the chassis was added to
+   */
+  void outputs_set(OutputStage& outputs);
+
+ private:
+  struct group {
+    std::array<pros::Motor*, MAX_GROUP_MOTORS> motors;
+    int motor_count;
+    pros::adi::DigitalOut* piston;
+    int mechanism_current;
+    pros::motor_brake_mode_e_t mechanism_brake;
+    pto_role role;
+  };
+  Drive* drive;
+  OutputStage* outputs = nullptr;
+  std::array<group, MAX_GROUPS> groups;
+  int group_count = 0;
+  uint32_t ports = 0;
+  pros::Motor* drive_motor_find(int port);
+};
+}  // namespace ez
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "fmt_buf.hpp"
+
+namespace ez {
+
+class ScreenText {
+ public:
+  /**
+   * Amount of lines on the brain screen.
+   */
+  static constexpr int LINES = 8;
+
+  /**
+   * Max characters in a line, longer lines are cut off.
+   */
+  static constexpr int WIDTH = 48;
+
+  /**
+   * Collects brain screen text for a frame and sends the lines that changed together with flush().
+   *
+   * Lines are formatted into fixed buffers, so nothing here touches the heap.
+   *
+   * \param period
+   *        min ms between flushes, defaults to 100
+   */
+  ScreenText(int period = 100);
+
+  /**
+   * Sets the min ms between flushes.
+   *
+   * \param ms
+   *        min ms between flushes
+   */
+  void period_set(int ms);
+
+  /**
+   * Returns true if flush() would send this frame.  Check this before formatting to skip frames that won't be shown.
+   */
+  bool due();
+
+  /**
+   * Formats a line like printf.  Nothing is sent until flush().
+   *
+   * \param line
+   *        line to print on, 0 to LINES - 1
+   * \param format
+   *        printf style format
+   */
+  void print(int line, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+  /**
+   * Clears a line.  Nothing is sent until flush().
+   *
+   * \param line
+   *        line to clear, 0 to LINES - 1
+   */
+  void clear(int line);
+
+  /**
+   * Sends every line that changed since it was last sent, if the period has passed.  Returns the amount of lines sent.
+   */
+  int flush();
+
+  /**
+   * Forgets what was last sent so flush() sends everything.  Use this after something else wrote to the screen, like changing pages.
+   */
+  void invalidate();
+
+ private:
+  std::array<fmt_buf<WIDTH + 1>, LINES> next;
+  std::array<fmt_buf<WIDTH + 1>, LINES> sent;
+  std::array<bool, LINES> written;
+  std::array<bool, LINES> stale;
+  int period;
+  uint32_t last_flush = 0;
+};
+}  // namespace ez
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+/**
+ * Enum for what a stall guard is doing.
+ */
+enum stall_state : uint8_t { STALL_WATCHING = 0,  // Running normally
+                             STALL_REVERSING = 1,  // Backing the jam out
+                             STALL_RETRYING = 2,   // Running forward again to see if the jam cleared
+                             STALL_FAILED = 3 };   // Out of retries, stopped for a moment before trying again
+
+/**
+ * One stall, kept for telemetry.
+ */
+struct stall_event {
+  uint32_t time;      // ms since the program started
+  int16_t current;    // mA when the stall was detected
+  int16_t velocity;   // rpm when the stall was detected
+  uint8_t attempts;   // reverse bursts it took
+  bool cleared;       // false if it ran out of retries
+};
+
+class StallGuard {
+ public:
+  /**
+   * Amount of stall events kept for telemetry.
+   */
+  static constexpr int LOG_SIZE = 16;
+
+  /**
+   * Watches a mechanism for stalls and backs jams out without blocking whoever is running it.
+   *
+   * Run iterate() on the control tick.  Run the motor with move() and brake() here, or tell the guard with command_set(),
+   * so the newest command is what the motor goes back to after a jam instead of what it was doing when it jammed.
+   *
+   * \param motor
+   *        the motor to watch
+   */
+  StallGuard(pros::Motor& motor);
+
+  /**
+   * Sets what counts as a stall.
+   *
+   * \param current
+   *        mA the motor draws when stalled, defaults to 1800
+   * \param velocity
+   *        rpm the motor is under when stalled, as a fraction of its cartridge's free speed, defaults to 0.1
+   * \param time
+   *        ms the motor has to be stalled for, defaults to 50
+   */
+  void stall_set(int current, double velocity, int time);
+
+  /**
+   * Sets how jams are backed out.
+   *
+   * \param speed
+   *        speed to reverse at, 0 to 127, defaults to 127
+   * \param reverse_time
+   *        ms to reverse for, defaults to 150
+   * \param retries
+   *        reverse bursts before giving up, defaults to 3
+   * \param cooldown
+   *        ms to stop for after giving up, defaults to 1000
+   */
+  void unjam_set(int speed, int reverse_time, int retries, int cooldown);
+
+  /**
+   * Enables or disables unjamming.  Stalls are still counted when disabled.
+   *
+   * \param enable
+   *        true enables, false disables
+   */
+  void unjam_enable(bool enable);
+
+  /**
+   * Runs the motor, or saves the command for when unjamming is done.
+   *
+   * \param voltage
+   *        -127 to 127
+   */
+  void move(int voltage);
+
+  /**
+   * Brakes the motor, or saves the command for when unjamming is done.
+   */
+  void brake();
+
+  /**
+   * Saves the newest command without running the motor, for code that runs the motor some other way, ie through an output stage.
+   *
+   * \param voltage
+   *        -127 to 127
+   */
+  void command_set(int voltage);
+
+  /**
+   * Checks the motor and runs the unjam routine.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Returns true while the guard has control of the motor.
+   */
+  bool unjamming();
+
+  /**
+   * Returns what the guard is doing.
+   */
+  stall_state state_get();
+
+  /**
+   * Returns how many stalls have happened.
+   */
+  int stalls_get();
+
+  /**
+   * Returns how many stalls ran out of retries.
+   */
+  int failures_get();
+
+  /**
+   * Returns a stall from the log, 0 is the newest.
+   *
+   * \param index
+   *        how many stalls ago, less than LOG_SIZE and stalls_get()
+   */
+  stall_event event_get(int index);
+
+  /**
+   * Prints stall counts and the log to the terminal.
+   */
+  void print();
+
+ private:
+  pros::Motor* motor;
+  stall_state state = STALL_WATCHING;
+  bool unjam_enabled = true;
+  int stall_current = 1800;
+  double stall_velocity = 0.1;
+  int stall_time = 50;
+  int reverse_speed = 127;
+  int reverse_time = 150;
+  int retries = 3;
+  int cooldown = 1000;
+  int stall_timer = 0;
+  int state_timer = 0;
+  int saved_voltage = 0;
+  int command = 0;
+  bool command_brake = false;
+  bool has_command = false;
+  int attempts = 0;
+  int stalls = 0;
+  int failures = 0;
+  std::array<stall_event, LOG_SIZE> log;
+  bool stalled();
+  void reverse();
+  void finish(bool cleared);
+  void restore();
+};
+}  // namespace ez
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "imu_fusion.hpp"
+
+namespace ez {
+namespace startup {
+
+/**
+ * Records how long startup has taken when a phase finishes.
+ *
+ * \param name
+ *        name of the phase that just finished, this must be a string literal
+ */
+void mark(const char* name);
+
+/**
+ * Prints every phase recorded with mark() to the terminal, call this at the end of initialize.
+ *
+ * If the IMU is still calibrating, the timing is printed once it's done so calibration shows up too.
+ */
+void print();
+
+/**
+ * Starts calibrating the IMU in its own task so the rest of initialize can keep going.
+ *
+ * The controller rumbles when calibration finishes, "." for success and "---" for failure.
+ *
+ * \param drive
+ *        the chassis whose IMU is calibrated
+ * \param fusion = nullptr
+ *        extra IMUs to calibrate at the same time as the chassis' IMU
+ */
+void imu_calibrate_async(Drive& drive, ImuFusion* fusion = nullptr);
+
+/**
+ * Blocks until IMU calibration started by imu_calibrate_async is done.  Returns true if it's done.
+ *
+ * \param timeout = 3000
+ *        most time to wait in ms
+ */
+bool imu_wait(int timeout = 3000);
+
+/**
+ * Returns true if IMU calibration started by imu_calibrate_async is done.
+ */
+bool imu_done();
+
+/**
+ * Restores the selected auton saved by selection_update.
+ *
+ * The saved page is ignored if the list of autons changed since it was saved.
+ *
+ * \param selector
+ *        the auton selector to restore
+ */
+bool selection_load(AutonSelector& selector);
+
+/**
+ * Saves the selected auton to the SD card when it changes.  This is cheap enough to call every loop.
+ *
+ * Nothing is saved until selection_load has run.
+ *
+ * \param selector
+ *        the auton selector to save
+ */
+void selection_update(AutonSelector& selector);
+
+}  // namespace startup
+}  // namespace ez
@@ -1,9 +1,24 @@
 #pragma once
 
 #include "EZ-Template/api.hpp"
+#include "alliance_link.hpp"
+#include "angular_pid.hpp"
 #include "api.h"
+#include "coprocessor.hpp"
+#include "field_view.hpp"
+#include "gps_correction.hpp"
+#include "imu_fusion.hpp"
+#include "macro.hpp"
+#include "mechanism.hpp"
+#include "motion_program.hpp"
+#include "odometry.hpp"
+#include "output_stage.hpp"
+#include "power_budget.hpp"
 #include "pros/adi.hpp"
 #include "pros/optical.hpp"
+#include "pto.hpp"
+#include "stall_guard.hpp"
+#include "vision_targets.hpp"
 
 extern Drive chassis;
 
@@ -22,5 +37,57 @@ inline bool hangState = 0;
 inline pros::Motor intake(15);
 inline pros::Motor arm(3);
 
+// Position control for the arm, constants and preset angles are set in default_constants().  The preset angles aren't measured yet
+inline ez::Mechanism arm_mech(arm);
+enum arm_presets { ARM_STOW = 0,
+                   ARM_LOAD = 1,
+                   ARM_WALL_STAKE = 2,
+                   ARM_ALLIANCE_STAKE = 3 };
+
+// Backs jammed rings out of the intake, code that runs the intake every loop skips it while this is unjamming
+inline ez::StallGuard intake_guard(intake);
+
 inline pros::Optical opticalSensor(1);
-inline pros::Optical opticalSensor2(13);
\ No newline at end of file
+inline pros::Optical opticalSensor2(13);
+
+// Fuses extra IMUs with the chassis' IMU, add them in initialize()
+inline ez::ImuFusion imu_fusion(chassis);
+
+// Tracks x and y from whole tracking wheel ticks alongside EZ-Template's own tracking
+inline ez::Odometry odometry(chassis);
+
+// Pulls odometry toward GPS fixes, uncomment this and its control tick in initialize() if there's a GPS
+// inline ez::GpsCorrection gps_correction(17, odometry);
+
+// Streams pose to a coprocessor and takes paths and corrections back, uncomment this and its setup in initialize() if there's one
+// inline ez::Coprocessor coprocessor(12);
+
+// Finds mogos and rings with the vision sensor, signatures are set in initialize()
+inline ez::VisionTargets vision(11, odometry);
+enum vision_kinds { TARGET_MOGO = 0,
+                    TARGET_RED_RING = 1,
+                    TARGET_BLUE_RING = 2 };
+
+// Runs the motion programs in autons.cpp
+inline ez::MotionRunner auton_runner(chassis);
+
+// Turns with derivative on the IMU, so chained turns don't kick.  Constants are set in default_constants()
+inline ez::AngularPID turn_pid;
+
+// Draws the field, the planned auton and where odometry has been on the second blank page
+inline ez::FieldView field_view(odometry);
+
+// Shares pose, auton step and claimed field elements with the alliance partner, start it in initialize()
+inline ez::AllianceLink alliance(20, odometry, auton_runner);
+
+// Records driver control sequences and replays them through auton_runner
+inline ez::MacroRecorder macros(chassis, auton_runner);
+
+// Sends everything opcontrol moves at the end of each loop
+inline ez::OutputStage outputs;
+
+// Lends drive motors to mechanisms, add groups to it in initialize()
+inline ez::PtoManager pto(chassis);
+
+// Splits current between the drive, intake and arm, and keeps motors from overheating
+inline ez::PowerBudget power(chassis, pto);
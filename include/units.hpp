@@ -0,0 +1,91 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+namespace ez {
+
+/**
+ * Same value as ez::ANGLE_NOT_SET, but usable at compile time.
+ */
+constexpr double CONSTEXPR_ANGLE_NOT_SET = 0.0000000000000000000001;
+
+/**
+ * Plain numbers or okapi units for each kind of quantity.  Plain numbers are inches, degrees and ms.
+ */
+template <class T>
+concept length_value = std::is_arithmetic_v<T> || std::is_same_v<T, okapi::QLength>;
+
+template <class T>
+concept angle_value = std::is_arithmetic_v<T> || std::is_same_v<T, okapi::QAngle>;
+
+template <class T>
+concept time_value = std::is_arithmetic_v<T> || std::is_same_v<T, okapi::QTime>;
+
+template <class T>
+concept pose_value = std::is_same_v<T, pose> || std::is_same_v<T, united_pose>;
+
+template <class T>
+concept odom_value = std::is_same_v<T, odom> || std::is_same_v<T, united_odom>;
+
+/**
+ * Strips okapi units down to the plain numbers the chassis uses.
+ *
+ * Everything here is constexpr, so unit literals like `24_in` become plain doubles at compile time.
+ */
+namespace units {
+
+template <length_value T>
+constexpr double in(T input) {
+  if constexpr (std::is_arithmetic_v<T>)
+    return input;
+  else
+    return input.convert(okapi::inch);
+}
+
+template <angle_value T>
+constexpr double deg(T input) {
+  if constexpr (std::is_arithmetic_v<T>)
+    return input;
+  else if (input.getValue() == (CONSTEXPR_ANGLE_NOT_SET * okapi::degree).getValue())
+    return CONSTEXPR_ANGLE_NOT_SET;  // Converting would round it, then it wouldn't be "not set" anymore
+  else
+    return input.convert(okapi::degree);
+}
+
+template <time_value T>
+constexpr double ms(T input) {
+  if constexpr (std::is_arithmetic_v<T>)
+    return input;
+  else
+    return input.convert(okapi::millisecond);
+}
+
+template <pose_value T>
+constexpr pose raw(const T& input) {
+  return {in(input.x), in(input.y), deg(input.theta)};
+}
+
+template <odom_value T>
+constexpr odom raw(const T& input) {
+  return {raw(input.target), input.drive_direction, input.max_xy_speed, input.turn_behavior};
+}
+
+/**
+ * Converts a list of movements in one pass.  Plain movements are moved through untouched.
+ */
+inline std::vector<odom> raw(std::vector<odom>&& inputs) { return std::move(inputs); }
+
+inline std::vector<odom> raw(const std::vector<united_odom>& inputs) {
+  std::vector<odom> outputs;
+  outputs.reserve(inputs.size());
+  for (const auto& input : inputs)
+    outputs.push_back(raw(input));
+  return outputs;
+}
+
+}  // namespace units
+}  // namespace ez
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "odometry.hpp"
+
+namespace ez {
+
+/**
+ * One field element the vision sensor has seen.
+ */
+struct vision_track {
+  int kind;            // What it is, set with signature_add()
+  double x;            // Field x in inches
+  double y;            // Field y in inches
+  double confidence;   // 0 to 1, goes up each time it's seen and down when it should have been
+  uint32_t last_seen;  // ms since the program started
+  int hits;            // Frames it's been seen in
+};
+
+class VisionTargets {
+ public:
+  /**
+   * Max amount of signatures.
+   */
+  static constexpr int MAX_SIGNATURES = 7;
+
+  /**
+   * Max amount of field elements tracked at once.
+   */
+  static constexpr int MAX_TRACKS = 8;
+
+  /**
+   * Finds field elements with the vision sensor and keeps track of where they are on the field.
+   *
+   * Each blob's bearing comes from where it is in the frame and its range from how wide it is, then odometry puts
+   * it on the field.  Blobs near a tracked element update it, and elements that stop showing up fade away.
+   *
+   * Run iterate() on the control tick.
+   *
+   * \param port
+   *        port the vision sensor is plugged into
+   * \param odometry
+   *        odometry for the robot the sensor is on
+   */
+  VisionTargets(int port, Odometry& odometry);
+
+  /**
+   * Sets where the vision sensor is on the robot.
+   *
+   * \param x
+   *        inches right of the center of the robot
+   * \param y
+   *        inches in front of the center of the robot
+   * \param angle
+   *        degrees the sensor is turned clockwise from facing forward, defaults to 0
+   */
+  void camera_set(double x, double y, double angle = 0.0);
+
+  /**
+   * Sets the sensor's horizontal field of view.
+   *
+   * \param degrees
+   *        field of view, defaults to 61
+   */
+  void fov_set(double degrees);
+
+  /**
+   * Adds a signature to look for.
+   *
+   * \param signature
+   *        signature id set in the vision utility, 1 to 7
+   * \param kind
+   *        what this signature is, tracks of the same kind are matched together
+   * \param width
+   *        how wide the element is in inches, used for range
+   */
+  void signature_add(int signature, int kind, double width);
+
+  /**
+   * Sets how blobs are matched to tracks.
+   *
+   * \param distance
+   *        inches a blob can be from a track to update it, defaults to 6
+   * \param max_age
+   *        ms a track lasts without being seen, defaults to 3000
+   */
+  void tracking_set(double distance, int max_age);
+
+  /**
+   * Reads the sensor and updates tracks.  Run this every ez::util::DELAY_TIME.
+   */
+  void iterate();
+
+  /**
+   * Finds the most likely tracked element of a kind near a point.  Returns false if there isn't one.
+   *
+   * \param kind
+   *        what to look for
+   * \param x
+   *        field x in inches, changed to the element's x if one is found
+   * \param y
+   *        field y in inches, changed to the element's y if one is found
+   * \param radius
+   *        farthest the element can be from the point in inches
+   * \param min_confidence
+   *        least confidence to use a track, defaults to 0.5
+   */
+  bool nearest(int kind, double& x, double& y, double radius, double min_confidence = 0.5);
+
+  /**
+   * Returns an odom motion with its target moved onto the nearest tracked element, or unchanged if none is close.
+   *
+   * \param kind
+   *        what to snap to
+   * \param target
+   *        the motion, ie {{-24.381, 44.471}, fwd, DRIVE_SPEED}
+   * \param radius
+   *        farthest to snap in inches
+   */
+  odom snap(int kind, odom target, double radius);
+
+  /**
+   * Returns how many elements are tracked.
+   */
+  int track_count();
+
+  /**
+   * Returns a tracked element.
+   *
+   * \param index
+   *        0 to track_count() - 1
+   */
+  vision_track track_get(int index);
+
+  /**
+   * Prints every tracked element.
+   */
+  void print();
+
+  /**
+   * The vision sensor.
+   */
+  pros::Vision sensor;
+
+ private:
+  struct signature {
+    int kind;
+    double width;
+  };
+  Odometry* odometry;
+  std::array<signature, MAX_SIGNATURES + 1> signatures = {};
+  std::array<vision_track, MAX_TRACKS> tracks = {};
+  int tracks_used = 0;
+  pose camera = {0.0, 0.0, 0.0};
+  double focal = 0.0;
+  double half_fov = 30.5;
+  double match_distance = 6.0;
+  int max_age = 3000;
+  void blob_add(int kind, double x, double y, uint32_t now);
+  void track_remove(int index);
+};
+}  // namespace ez
@@ -0,0 +1,130 @@
+#include "alliance_link.hpp"
+
+#include <cmath>
+
+using namespace ez;
+
+static constexpr uint8_t LINK_VERSION = 2;
+// Poses older than this are too stale to steer around
+static constexpr int PARTNER_TIMEOUT = 500;
+// PROS wraps each packet in a start byte, size and checksum
+static constexpr int PACKET_OVERHEAD = 4;
+
+AllianceLink::AllianceLink(int port, Odometry& odometry, MotionRunner& runner) : port(port), odometry(&odometry), runner(&runner) {}
+
+void AllianceLink::start(const char* id, bool transmitter) {
+  if (link != nullptr) return;
+  link = new pros::Link(port, id, transmitter ? pros::E_LINK_TX : pros::E_LINK_RX);
+}
+
+void AllianceLink::loopback_set(bool enable) { loopback = enable; }
+
+void AllianceLink::period_set(int ms) { period = ms; }
+
+void AllianceLink::origin_set(pose input) {
+  origin_mutex.take();
+  origin = input;
+  has_origin = true;
+  origin_mutex.give();
+}
+
+void AllianceLink::origin_clear() {
+  origin_mutex.take();
+  has_origin = false;
+  origin_mutex.give();
+}
+
+void AllianceLink::claim(int element) {
+  if (element < 0 || element >= MAX_ELEMENTS) {
+    printf("Alliance Link: element %i is out of range!\n", element);
+    return;
+  }
+  claims |= 1u << element;
+}
+
+void AllianceLink::release(int element) {
+  if (element < 0 || element >= MAX_ELEMENTS) return;
+  claims &= ~(1u << element);
+}
+
+void AllianceLink::release_all() { claims = 0; }
+
+bool AllianceLink::claimed(int element) { return element >= 0 && element < MAX_ELEMENTS && (claims >> element) & 1; }
+
+bool AllianceLink::partner_claimed(int element) { return element >= 0 && element < MAX_ELEMENTS && partner_fresh() && (partner.claimed >> element) & 1; }
+
+pose AllianceLink::partner_pose_get() { return {partner.x / 10.0, partner.y / 10.0, partner.theta / 10.0}; }
+
+int AllianceLink::partner_step_get() { return partner_fresh() ? partner.step : -1; }
+
+int AllianceLink::partner_age_get() { return partner_seen ? pros::millis() - partner_time : -1; }
+
+bool AllianceLink::partner_fresh() { return partner_seen && partner_age_get() < PARTNER_TIMEOUT; }
+
+bool AllianceLink::partner_near(double x, double y, double radius) {
+  if (!partner_fresh() || !(partner.flags & LINK_FIELD_POSE)) return false;
+  pose other = partner_pose_get();
+  return hypot(other.x - x, other.y - y) < radius;
+}
+
+void AllianceLink::packet_handle(const link_state& packet) {
+  if (packet.version != LINK_VERSION) return;
+  // Every packet is the whole state, so a gap only means the partner's state was older for a moment
+  if (partner_seen) lost += (uint8_t)(packet.sequence - partner.sequence - 1);
+  partner = packet;
+  partner_time = pros::millis();
+  partner_seen = true;
+  received++;
+}
+
+void AllianceLink::iterate() {
+  // Take everything waiting, only the newest packet matters
+  if (loopback && has_loopback_packet) {
+    packet_handle(loopback_packet);
+    has_loopback_packet = false;
+  } else if (!loopback && link != nullptr && link->connected()) {
+    link_state packet;
+    while (link->raw_receivable_size() >= sizeof(link_state) + PACKET_OVERHEAD) {
+      if (link->receive(&packet, sizeof(packet)) != sizeof(packet)) break;
+      packet_handle(packet);
+    }
+  }
+
+  timer -= util::DELAY_TIME;
+  if (timer > 0) return;
+  timer = period;
+
+  // Odometry is turned and moved onto the field, 0 degrees is facing +y and angles increase clockwise
+  pose local = odometry->pose_get();
+  origin_mutex.take();
+  pose field_origin = origin;
+  bool field = has_origin;
+  origin_mutex.give();
+  double angle = util::to_rad(field_origin.theta);
+  pose current = {field_origin.x + local.x * cos(angle) + local.y * sin(angle),
+                  field_origin.y - local.x * sin(angle) + local.y * cos(angle),
+                  local.theta + field_origin.theta};
+  link_state packet = {LINK_VERSION,
+                       sequence++,
+                       (int16_t)util::clamp(current.x * 10.0, INT16_MAX, INT16_MIN),
+                       (int16_t)util::clamp(current.y * 10.0, INT16_MAX, INT16_MIN),
+                       (int16_t)util::clamp(util::wrap_angle(current.theta) * 10.0, INT16_MAX, INT16_MIN),
+                       (int8_t)std::min(runner->step_get(), (int)INT8_MAX),
+                       field ? LINK_FIELD_POSE : (uint8_t)0,
+                       claims};
+  if (loopback) {
+    loopback_packet = packet;
+    has_loopback_packet = true;
+    sent++;
+  } else if (link != nullptr && link->connected() && link->raw_transmittable_size() >= sizeof(packet) + PACKET_OVERHEAD) {
+    // A full radio buffer skips this packet, the next one has newer state anyway
+    if (link->transmit(&packet, sizeof(packet)) == sizeof(packet)) sent++;
+  }
+}
+
+void AllianceLink::print() {
+  pose other = partner_pose_get();
+  printf("Alliance link on port %i: %s, %i sent, %i received, %i lost\n", port, loopback ? "loopback" : (link != nullptr && link->connected() ? "connected" : "not connected"), sent, received, lost);
+  if (partner_seen)
+    printf("  partner x %.1f  y %.1f  a %.1f%s  step %i  claims 0x%08lx  %i ms ago\n", other.x, other.y, other.theta, partner.flags & LINK_FIELD_POSE ? "" : " (not on the field)", partner.step, (unsigned long)partner.claimed, partner_age_get());
+}
@@ -0,0 +1,134 @@
+#include "angular_pid.hpp"
+
+#include <cmath>
+
+using namespace ez;
+
+// Heading change per tick that counts as stopped for the velocity exit
+static constexpr double STOPPED_RATE = 0.01;
+
+AngularPID::AngularPID() {}
+
+AngularPID::AngularPID(double p, double i, double d, double start_i) { constants_set(p, i, d, start_i); }
+
+void AngularPID::constants_set(double p, double i, double d, double start_i) { constants = {p, i, d, start_i}; }
+
+void AngularPID::constants_set(PID::Constants input) { constants = input; }
+
+PID::Constants AngularPID::constants_get() { return constants; }
+
+void AngularPID::derivative_filter_set(double amount) { filter = util::clamp(amount, 1.0, 0.0); }
+
+void AngularPID::exit_condition_set(int input_small_exit_time, double input_small_error, int input_big_exit_time, double input_big_error, int input_velocity_exit_time) {
+  small_exit_time = input_small_exit_time;
+  small_error = input_small_error;
+  big_exit_time = input_big_exit_time;
+  big_error = input_big_error;
+  velocity_exit_time = input_velocity_exit_time;
+}
+
+void AngularPID::target_set(double input, double current, e_angle_behavior behavior) {
+  // Directional behaviors unwrap the target so the error runs the whole way around,
+  // shortest keeps wrapping the error so it works on headings that wrap too
+  double offset = util::wrap_angle(input - current);
+  wrap = behavior == shortest;
+  switch (behavior) {
+    case raw:
+      target = input;
+      break;
+    case cw:
+      target = current + (offset < 0.0 ? offset + 360.0 : offset);
+      break;
+    case ccw:
+      target = current + (offset > 0.0 ? offset - 360.0 : offset);
+      break;
+    case longest:
+      target = current + (offset > 0.0 ? offset - 360.0 : (offset < 0.0 ? offset + 360.0 : offset));
+      break;
+    default:
+      target = current + offset;
+      break;
+  }
+  small_timer = big_timer = velocity_timer = 0;
+}
+
+double AngularPID::target_get() { return target; }
+
+double AngularPID::compute(double current) {
+  // A gap since the last compute means the heading change isn't from one tick, so it's skipped
+  if (started && pros::millis() - last_time > 2 * util::DELAY_TIME) {
+    started = false;
+    derivative = 0.0;
+  }
+  double change = started ? current - last_current : 0.0;
+  if (wrap) change = util::wrap_angle(change);
+  return output_update(current, change);
+}
+
+double AngularPID::compute(double current, double rate) { return output_update(current, rate * util::DELAY_TIME / 1000.0); }
+
+double AngularPID::output_update(double current, double change) {
+  error = target - current;
+  if (wrap) error = util::wrap_angle(error);
+
+  // Integral only builds close to the target and clears when the target is crossed
+  if (constants.ki != 0.0) {
+    if (constants.start_i != 0.0 && fabs(error) > constants.start_i)
+      integral = 0.0;
+    else
+      integral += error;
+    if (util::sgn(error) != util::sgn(integral)) integral = 0.0;
+  }
+
+  // The heading moving toward the target is a negative derivative of the error, target jumps don't show up here
+  derivative += (change - derivative) * filter;
+  last_current = current;
+  last_time = pros::millis();
+  started = true;
+
+  output = constants.kp * error + constants.ki * integral - constants.kd * derivative;
+  return output;
+}
+
+double AngularPID::error_get() { return error; }
+
+double AngularPID::output_get() { return output; }
+
+void AngularPID::variables_reset() {
+  integral = 0.0;
+  derivative = 0.0;
+  started = false;
+  small_timer = big_timer = velocity_timer = 0;
+}
+
+exit_output AngularPID::exit_condition() {
+  if (small_exit_time != 0) {
+    small_timer = fabs(error) < small_error ? small_timer + util::DELAY_TIME : 0;
+    if (small_timer >= small_exit_time) return SMALL_EXIT;
+  }
+  if (big_exit_time != 0) {
+    big_timer = fabs(error) < big_error ? big_timer + util::DELAY_TIME : 0;
+    if (big_timer >= big_exit_time) return BIG_EXIT;
+  }
+  if (velocity_exit_time != 0) {
+    velocity_timer = fabs(derivative) < STOPPED_RATE ? velocity_timer + util::DELAY_TIME : 0;
+    if (velocity_timer >= velocity_exit_time) return VELOCITY_EXIT;
+  }
+  return RUNNING;
+}
+
+bool ez::angular_turn(Drive& drive, AngularPID& pid, double target, int speed, e_angle_behavior behavior, int timeout) {
+  drive.drive_mode_set(DISABLE, false);
+  pid.target_set(target, drive.drive_imu_get(), behavior);
+
+  exit_output exit = RUNNING;
+  uint32_t now = pros::millis();
+  for (int time = 0; exit == RUNNING && time < timeout; time += util::DELAY_TIME) {
+    int output = std::round(util::clamp(pid.compute(drive.drive_imu_get()), speed, -speed));
+    drive.drive_set(output, -output);
+    exit = pid.exit_condition();
+    pros::Task::delay_until(&now, util::DELAY_TIME);
+  }
+  drive.drive_set(0, 0);
+  return exit != RUNNING;
+}
@@ -2,6 +2,8 @@
 #include "EZ-Template/util.hpp"
 #include "colordetect.hpp"
 #include "main.h"
+#include "mirror.hpp"
+#include "motion_program.hpp"
 #include "pros/abstract_motor.hpp"
 #include "pros/rtos.hpp"
 #include "subsystems.hpp"
@@ -55,6 +57,21 @@ void default_constants() {
   chassis.odom_boomerang_dlead_set(0.625);     // This handles how aggressive the end of boomerang motions are
 
   chassis.pid_angle_behavior_set(ez::shortest);  // Changes the default behavior for turning, this defaults it to the shortest path there
+
+  // ez::angular_turn(chassis, turn_pid, 90, TURN_SPEED) turns with these instead of the chassis turnPID
+  turn_pid.constants_set(chassis.turnPID.constants_get());
+  turn_pid.exit_condition_set(90, 3.0, 250, 7.0, 500);
+
+  // Arm, angles are degrees of the arm with 0 stowed against the hard stop
+  arm_mech.constants_set(3.0, 0.0, 10.0);                 // P, I, D for holding the arm on its profile
+  arm_mech.exit_condition_set(80, 2, 250, 5, 250, 500);  // Same as the chassis exit conditions, in ms and degrees
+  arm_mech.profile_set(360, 1440);                       // Max speed in deg/s, acceleration in deg/s/s
+  arm_mech.feedforward_set(8, 90);                       // Output to hold the arm level, and the angle it's level at
+  // Placeholder angles until they're measured on the robot, the autons run the arm open loop until then
+  arm_mech.preset_set(ARM_STOW, "stow", 0);
+  arm_mech.preset_set(ARM_LOAD, "load", 30);
+  arm_mech.preset_set(ARM_WALL_STAKE, "wall stake", 135);
+  arm_mech.preset_set(ARM_ALLIANCE_STAKE, "alliance stake", 190);
 }
 
 ///
@@ -93,6 +110,25 @@ void turn_example() {
   chassis.pid_wait();
 }
 
+///
+// Angular PID Turn Example
+///
+void angular_turn_example() {
+  // Same turns as turn_example, but with turn_pid
+  // These block until the turn exits, so there's no pid_wait()
+
+  ez::angular_turn(chassis, turn_pid, 90, TURN_SPEED);
+  ez::angular_turn(chassis, turn_pid, 45, TURN_SPEED);
+  ez::angular_turn(chassis, turn_pid, 0, TURN_SPEED);
+
+  // Directions work like pid_turn_set, this goes the long way around
+  ez::angular_turn(chassis, turn_pid, 90, TURN_SPEED, ez::longest);
+
+  // False means it ran out of time before settling, ie the constants need tuning
+  if (!ez::angular_turn(chassis, turn_pid, 0, TURN_SPEED))
+    printf("Angular turn to 0 timed out\n");
+}
+
 ///
 // Combining Turn + Drive
 ///
@@ -353,7 +389,7 @@ void measure_offsets() {
     chassis.drive_imu_reset();
     chassis.drive_sensor_reset();
     chassis.drive_brake_set(pros::E_MOTOR_BRAKE_HOLD);
-    chassis.odom_xyt_set(0_in, 0_in, 0_deg);
+    odometry.pose_set({0.0, 0.0, 0.0});
     double imu_start = chassis.odom_theta_get();
     double target = i % 2 == 0 ? 90 : 270;  // Switch the turn target every run from 270 to 90
 
@@ -395,330 +431,320 @@ void measure_offsets() {
 // Make your own autonomous functions here!
 // . . .
 
-void redLeftAWP(){
-  chassis.odom_xyt_set(0,0,0);
-  arm.move(127);
-  chassis.pid_odom_set(-23_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.brake();
-  chassis.pid_turn_set(90,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(-6_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  pros::Task colorsort(redsort);
-  pros::delay(750);
 
-  chassis.odom_xyt_set(-58.761,0,90);
-  chassis.pid_odom_set(4_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set({-28.937,21.067},rev,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-28.937,21.067},rev,DRIVE_SPEED});
-  chassis.pid_wait();
-  chassis.pid_odom_set(-4_in,40);
-  chassis.pid_wait();
-  mogo.set_value(1);
-  pros::delay(250);
-
-  chassis.pid_turn_set({-24.381,44.471},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-24.381,44.471},fwd,DRIVE_SPEED});
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(70,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(12_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  pros::delay(500);
-  chassis.pid_odom_set(-13_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set(135,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(23_in,DRIVE_SPEED);
-  chassis.pid_wait();
-
-  colorsort.remove();
+pros::Task* colorsort_task = nullptr;
+
+void motion_actuators_set() {
+  // Positive and negative values run the arm, 0 holds it where it is
+  auton_runner.actuator_add(ARM, [](int value, bool) { arm_mech.manual(value); });
+  // Moves the arm to a preset from arm_presets without waiting
+  auton_runner.actuator_add(ARM_PRESET, [](int value, bool) { arm_mech.move_to(value); });
+  auton_runner.actuator_add(MOGO, [](int value, bool) {
+    mogoState = value;
+    mogo.set_value(value);
+  });
+  auton_runner.actuator_add(INTAKE, [](int value, bool) {
+    if (value == 0)
+      intake_guard.brake();
+    else
+      intake_guard.move(value);
+  });
+  // Mirrored programs are on the blue side, so they sort for blue
+  auton_runner.actuator_add(COLOR_SORT, [](int value, bool mirrored) {
+    if (colorsort_task != nullptr) {
+      colorsort_task->remove();
+      delete colorsort_task;
+      colorsort_task = nullptr;
+    }
+    if (value != 0)
+      colorsort_task = new pros::Task(mirrored ? bluesort : redsort);
+  });
+  // Snapped steps go to the nearest tracked element, mirrored programs are on the blue side so they go for blue rings
+  auton_runner.snap_set([](int kind, bool mirrored, double radius, double& x, double& y) {
+    if (mirrored && kind == TARGET_RED_RING) kind = TARGET_BLUE_RING;
+    return vision.nearest(kind, x, y, radius);
+  });
+  auton_runner.actuator_add(DOINK, [](int value, bool) {
+    doinkState = value;
+    doink.set_value(value);
+  });
+  auton_runner.actuator_add(HANG, [](int value, bool) {
+    hangState = value;
+    hang.set_value(value);
+  });
+
+  // Tells the alliance partner we're going for an element, motion::skip_if(element, steps) skips ones the partner claimed or is already at
+  auton_runner.actuator_add(CLAIM, [](int value, bool) { alliance.claim(value); });
+  for (int element = 0; element < ELEMENT_COUNT; element++) {
+    auton_runner.trigger_add(element, [element]() {
+      // Elements are on the red side, the partner is always on our side so checking both sides is safe
+      pose spot = ELEMENT_POSITIONS[element];
+      return alliance.partner_claimed(element) || alliance.partner_near(spot.x, spot.y, 12) || alliance.partner_near(-spot.x, spot.y, 12);
+    });
+  }
 }
 
-void blueRightAWP(){
-  chassis.odom_xyt_set(0,0,0);
-  arm.move(127);
-  chassis.pid_odom_set(-23_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.brake();
-  chassis.pid_turn_set(-90,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(-6_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  pros::Task colorsort(bluesort);
-  pros::delay(750);
+// Blue right is this program flipped across the field
+constexpr std::array RED_LEFT_AWP = {
+    motion::pose_set(-52.761, 23, 0),
+    motion::actuator(ARM, 127),
+    motion::odom_drive(-23, DRIVE_SPEED),
+    motion::wait(),
+    motion::actuator(ARM, 0),
+    motion::turn(90, TURN_SPEED),
+    motion::wait(),
+    motion::odom_drive(-6, DRIVE_SPEED),
+    motion::wait(),
+    motion::actuator(COLOR_SORT, 1),
+    motion::delay(750),
+
+    motion::pose_set(-58.761, 0, 90),
+    motion::odom_drive(4, DRIVE_SPEED),
+    motion::wait(),
+    motion::turn_to_point(-28.937, 21.067, rev, TURN_SPEED),
+    motion::wait(),
+    motion::odom_move(-28.937, 21.067, rev, DRIVE_SPEED),
+    motion::wait(),
+    motion::odom_drive(-4, 40),
+    motion::wait(),
+    motion::actuator(MOGO, 1),
+    motion::delay(250),
+
+    motion::skip_if(ELEMENT_RING_STACK_LEFT, 12),  // Leave the ring stack to the partner if they're going for it
+    motion::actuator(CLAIM, ELEMENT_RING_STACK_LEFT),
+    motion::snap(motion::turn_to_point(-24.381, 44.471, fwd, TURN_SPEED), TARGET_RED_RING, 8),
+    motion::wait(),
+    motion::snap(motion::odom_move(-24.381, 44.471, fwd, DRIVE_SPEED), TARGET_RED_RING, 8),
+    motion::wait(),
+
+    motion::turn(70, TURN_SPEED),
+    motion::wait(),
+    motion::odom_drive(12, DRIVE_SPEED),
+    motion::wait(),
+    motion::delay(500),
+    motion::odom_drive(-13, DRIVE_SPEED),
+    motion::wait(),
+    motion::turn(135, TURN_SPEED),
+    motion::wait(),
+    motion::odom_drive(23, DRIVE_SPEED),
+    motion::wait(),
+
+    motion::actuator(COLOR_SORT, 0),
+    motion::end()};
+
+constexpr std::array BLUE_RIGHT_AWP = ez::motion_mirror<ez::mirror_axis::x>(RED_LEFT_AWP);
+
+// Programs start in field coordinates, so the alliance partner can use our pose as is
+void redLeftAWP() {
+  alliance.origin_set({0, 0, 0});
+  auton_runner.run(RED_LEFT_AWP);
+}
 
-  chassis.odom_xyt_set(58.761,0,-90);
-  chassis.pid_odom_set(4_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set({28.937,21.067},rev,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{28.937,21.067},rev,DRIVE_SPEED});
-  chassis.pid_wait();
-  chassis.pid_odom_set(-4_in,40);
-  chassis.pid_wait();
-  mogo.set_value(1);
-  pros::delay(250);
+void blueRightAWP() {
+  alliance.origin_set({0, 0, 0});
+  auton_runner.run(BLUE_RIGHT_AWP);
+}
 
-  chassis.pid_turn_set({24.381,44.471},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{24.381,44.471},fwd,DRIVE_SPEED});
-  chassis.pid_wait();
+// Returns the motion program an auton runs, or an empty program if it's a normal function
+std::span<const ez::motion_step> auton_program_get(std::function<void()> auton) {
+  auto function = auton.target<void (*)()>();
+  if (function == nullptr)
+    return {};
+  if (*function == redLeftAWP)
+    return RED_LEFT_AWP;
+  if (*function == blueRightAWP)
+    return BLUE_RIGHT_AWP;
+  return {};
+}
 
-  chassis.pid_turn_set(-70,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(12_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  pros::delay(500);
-  chassis.pid_odom_set(-13_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set(-135,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(23_in,DRIVE_SPEED);
-  chassis.pid_wait();
+void auton_plan_selected() {
+  static int last_page = -1;
+  int page = ez::as::auton_selector.auton_page_current;
+  if (page == last_page || page < 0 || page >= (int)ez::as::auton_selector.Autons.size())
+    return;
+  last_page = page;
 
-  colorsort.remove();
+  std::span<const ez::motion_step> program = auton_program_get(ez::as::auton_selector.Autons[page].auton_call);
+  if (program.empty()) {
+    auton_runner.plan_clear();
+    field_view.plan_set({});
+    return;
+  }
+  if (auton_runner.plan(program))
+    auton_runner.plan_print();
+  field_view.plan_set(auton_runner.plan_poses_get());
 }
 
-void redLeftRingRush(){
-  arm.move(127);
-  chassis.odom_xyt_set(-58.706,46.997,-55);
-  chassis.pid_odom_set(-32_in,63);
-  chassis.pid_wait();
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.brake();
-  chassis.pid_odom_set(-4_in,40);
-  chassis.pid_wait();
+// Written for red left, ez::mirror_axis::x runs it as blue right
+template <ez::mirror_axis A>
+void ringRush() {
+  ez::Mirrored<A> drive(chassis);
+  arm_mech.manual(127);
+  drive.odom_xyt_set(-58.706,46.997,-55);
+  drive.pid_odom_set(-32_in,63);
+  drive.pid_wait();
+  arm_mech.manual(0);
+  drive.pid_odom_set(-4_in,40);
+  drive.pid_wait();
   mogo.set_value(1);
   pros::delay(250);
 
-  chassis.pid_turn_set(50, TURN_SPEED);
-  chassis.pid_wait();
-  pros::Task colorsort(redsort);
-  chassis.pid_odom_set(25_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set(10_deg, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(7_in,DRIVE_SPEED);
-  chassis.pid_wait();
+  drive.pid_turn_set(50, TURN_SPEED);
+  drive.pid_wait();
+  pros::Task colorsort(A == ez::mirror_axis::x ? bluesort : redsort);
+  drive.pid_odom_set(25_in, DRIVE_SPEED);
+  drive.pid_wait();
+  drive.pid_turn_set(10_deg, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set(7_in,DRIVE_SPEED);
+  drive.pid_wait();
   pros::delay(500);
-  chassis.pid_odom_set(-15_in, DRIVE_SPEED);
-  chassis.pid_wait();
+  drive.pid_odom_set(-15_in, DRIVE_SPEED);
+  drive.pid_wait();
 
-  chassis.pid_turn_set({-23.345,47.163},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(12_in, DRIVE_SPEED);
-  chassis.pid_wait();
+  drive.pid_turn_set({-23.345,47.163},fwd,TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set(12_in, DRIVE_SPEED);
+  drive.pid_wait();
   pros::delay(250);
 
-  chassis.pid_turn_set({-47,0},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-47,0},fwd,DRIVE_SPEED});
-  chassis.pid_wait();
+  drive.pid_turn_set({-47,0},fwd,TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-47,0},fwd,DRIVE_SPEED});
+  drive.pid_wait();
 
-  chassis.pid_drive_set(8_in,DRIVE_SPEED);
-  chassis.pid_wait();
+  drive.pid_drive_set(8_in,DRIVE_SPEED);
+  drive.pid_wait();
 
   colorsort.remove();
 }
 
-void blueRightRingRush(){
-  arm.move(127);
-  chassis.odom_xyt_set(58.706,46.997,55);
-  chassis.pid_odom_set(-32_in,63);
-  chassis.pid_wait();
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.brake();
-  chassis.pid_odom_set(-4_in,40);
-  chassis.pid_wait();
-  mogo.set_value(1);
-  pros::delay(250);
-
-  chassis.pid_turn_set(-50, TURN_SPEED);
-  chassis.pid_wait();
-  pros::Task colorsort(bluesort);
-  chassis.pid_odom_set(25_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set(-10_deg, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(7_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  pros::delay(500);
-  chassis.pid_odom_set(-15_in, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set({23.345,47.163},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(12_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  pros::delay(250);
-
-  chassis.pid_turn_set({47,0},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{47,0},fwd,DRIVE_SPEED});
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(8_in,DRIVE_SPEED);
-  chassis.pid_wait();
+void redLeftRingRush() {
+  ringRush<ez::mirror_axis::none>();
+}
 
-  colorsort.remove();
+void blueRightRingRush() {
+  ringRush<ez::mirror_axis::x>();
 }
 
-void redRightSafe(){
-  chassis.odom_xyt_set(0,0,180);
-  arm.move(127);
-  chassis.pid_odom_set(-23_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.brake();
-  chassis.pid_turn_set(90,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(-6_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  intake.move(127);
+// Written for red right, ez::mirror_axis::x runs it as blue left
+template <ez::mirror_axis A>
+void safe() {
+  ez::Mirrored<A> drive(chassis);
+  drive.odom_xyt_set(0,0,180);
+  arm_mech.manual(127);
+  drive.pid_odom_set(-23_in, DRIVE_SPEED);
+  drive.pid_wait();
+  arm_mech.manual(0);
+  drive.pid_turn_set(90,TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set(-6_in, DRIVE_SPEED);
+  drive.pid_wait();
+  intake_guard.move(127);
   pros::delay(750);
-  intake.brake();
-
-  chassis.odom_xyt_set(-58.761,0,90);
-  chassis.pid_odom_set(4_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set({-28.937,-21.067},rev,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-28.937,-21.067},rev,DRIVE_SPEED});
-  chassis.pid_wait();
-  chassis.pid_odom_set(-4_in,40);
-  chassis.pid_wait();
+  intake_guard.brake();
+
+  drive.odom_xyt_set(-58.761,0,90);
+  drive.pid_odom_set(4_in,DRIVE_SPEED);
+  drive.pid_wait();
+  drive.pid_turn_set({-28.937,-21.067},rev,TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-28.937,-21.067},rev,DRIVE_SPEED});
+  drive.pid_wait();
+  drive.pid_odom_set(-4_in,40);
+  drive.pid_wait();
   mogo.set_value(1);
   pros::delay(250);
 
-  chassis.pid_turn_set({-24.381,-44.471},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  intake.move(127);
-  chassis.pid_odom_set({{-24.381,-44.471},fwd,DRIVE_SPEED});
-  chassis.pid_wait();
+  drive.pid_turn_set({-24.381,-44.471},fwd,TURN_SPEED);
+  drive.pid_wait();
+  intake_guard.move(127);
+  drive.pid_odom_set({{-24.381,-44.471},fwd,DRIVE_SPEED});
+  drive.pid_wait();
 
-  chassis.pid_turn_set(45,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(23_in,DRIVE_SPEED);
-  chassis.pid_wait();
+  drive.pid_turn_set(45,TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set(23_in,DRIVE_SPEED);
+  drive.pid_wait();
 }
 
-void blueLeftSafe(){
-  chassis.odom_xyt_set(0,0,180);
-  arm.move(127);
-  chassis.pid_odom_set(-23_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.brake();
-  chassis.pid_turn_set(-90,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(-6_in, DRIVE_SPEED);
-  chassis.pid_wait();
-  intake.move(127);
-  pros::delay(750);
-  intake.brake();
-
-  chassis.odom_xyt_set(58.761,0,-90);
-  chassis.pid_odom_set(4_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set({28.937,-21.067},rev,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{28.937,-21.067},rev,DRIVE_SPEED});
-  chassis.pid_wait();
-  chassis.pid_odom_set(-4_in,40);
-  chassis.pid_wait();
-  mogo.set_value(1);
-  pros::delay(250);
-
-  chassis.pid_turn_set({24.381,-44.471},fwd,TURN_SPEED);
-  chassis.pid_wait();
-  intake.move(127);
-  chassis.pid_odom_set({{24.381,-44.471},fwd,DRIVE_SPEED});
-  chassis.pid_wait();
+void redRightSafe() {
+  safe<ez::mirror_axis::none>();
+}
 
-  chassis.pid_turn_set(-45,TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set(23_in,DRIVE_SPEED);
-  chassis.pid_wait();
+void blueLeftSafe() {
+  safe<ez::mirror_axis::x>();
 }
 
-// close side skills
+// close side skills, ez::mirror_axis::y runs it on the other side of the field
+template <ez::mirror_axis A>
 void closeBase() {
-  chassis.pid_turn_set({-47.07, 17.854}, rev, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-47.07, 17.854}, rev, 30});
-  chassis.pid_wait();
+  ez::Mirrored<A> drive(chassis);
+  drive.pid_turn_set({-47.07, 17.854}, rev, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-47.07, 17.854}, rev, 30});
+  drive.pid_wait();
   mogo.set_value(1);
   pros::delay(250);
-  chassis.pid_turn_set({-23.752, 23.581}, fwd, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-23.752, 23.581}, fwd, RING_SPEED});
-  chassis.pid_wait();
-  chassis.pid_turn_set({-2.684, 55.49}, fwd, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-2.684, 55.49}, fwd, RING_SPEED});
-  chassis.pid_wait();
-  chassis.pid_odom_set(-12_in,DRIVE_SPEED);
-  chassis.pid_wait();
-  chassis.pid_turn_set({-23.547, 47.104}, fwd, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-23.547, 47.104}, fwd, RING_SPEED});
-  chassis.pid_wait();
-  chassis.pid_turn_set({-58.933, 47.104}, fwd, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-58.933, 47.104}, fwd, 30});
-  chassis.pid_wait();
+  drive.pid_turn_set({-23.752, 23.581}, fwd, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-23.752, 23.581}, fwd, RING_SPEED});
+  drive.pid_wait();
+  drive.pid_turn_set({-2.684, 55.49}, fwd, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-2.684, 55.49}, fwd, RING_SPEED});
+  drive.pid_wait();
+  drive.pid_odom_set(-12_in,DRIVE_SPEED);
+  drive.pid_wait();
+  drive.pid_turn_set({-23.547, 47.104}, fwd, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-23.547, 47.104}, fwd, RING_SPEED});
+  drive.pid_wait();
+  drive.pid_turn_set({-58.933, 47.104}, fwd, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-58.933, 47.104}, fwd, 30});
+  drive.pid_wait();
   // chassis.pid_turn_set({-58.933, 47.104}, fwd, TURN_SPEED);
   // chassis.pid_wait();
   // chassis.pid_odom_set({{-58.933, 47.104}, fwd, DRIVE_SPEED});
   // chassis.pid_wait();
-  chassis.pid_turn_set({-47.274, 58.763}, fwd, TURN_SPEED);
-  chassis.pid_wait();
-  chassis.pid_odom_set({{-47.274, 58.763}, fwd, 40});
-  chassis.pid_wait();
-  chassis.pid_turn_set({-61.592, 63.501}, rev, TURN_SPEED);
-  chassis.pid_wait();
+  drive.pid_turn_set({-47.274, 58.763}, fwd, TURN_SPEED);
+  drive.pid_wait();
+  drive.pid_odom_set({{-47.274, 58.763}, fwd, 40});
+  drive.pid_wait();
+  drive.pid_turn_set({-61.592, 63.501}, rev, TURN_SPEED);
+  drive.pid_wait();
   mogo.set_value(0);
   pros::delay(250);
-  chassis.pid_odom_set({{-61.592, 63.501}, rev, DRIVE_SPEED});
-  chassis.pid_wait();
+  drive.pid_odom_set({{-61.592, 63.501}, rev, DRIVE_SPEED});
+  drive.pid_wait();
 }
 
 // Skills Challenge
 void skills() {
-  arm.set_brake_mode(pros::MotorBrake::hold);
-  arm.move(127);
-  chassis.odom_xyt_set(-60.161, 0, 90);
-  intake.move(127);
+  // Skills is a minute of driving, keep current on the drive and let hot motors cool
+  power.priority_set(ez::BUDGET_DRIVE);
+  arm_mech.manual(127);
+  odometry.pose_set({-60.161, 0.0, 90.0});
+  intake_guard.move(127);
   pros::delay(250);
-  arm.brake();
+  arm_mech.manual(0);
   chassis.pid_odom_set({{-47.07, 0}, fwd, DRIVE_SPEED});
   chassis.pid_wait();
 
-  closeBase();
+  closeBase<ez::mirror_axis::none>();
 
   chassis.pid_turn_set({-47.07, 0}, fwd, TURN_SPEED);
   chassis.pid_wait();
   chassis.pid_odom_set({{-47.07, 0}, fwd, DRIVE_SPEED});
   chassis.pid_wait();
   
-  intake.move(127);
-  chassis.odom_y_flip();
-  // chassis.odom_theta_flip();
-
-  closeBase();
-  chassis.odom_y_flip(false);
+  intake_guard.move(127);
+  closeBase<ez::mirror_axis::y>();
   intake.move_voltage(127);
   chassis.pid_odom_set({{23.788, -47.077}, fwd, DRIVE_SPEED});
   chassis.pid_wait();
-  intake.brake();
+  intake_guard.brake();
 
   chassis.pid_turn_set({56.599,17.546}, fwd, TURN_SPEED);
   chassis.pid_wait();
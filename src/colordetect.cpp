@@ -9,9 +9,14 @@ void bluesort(){
     opticalSensor.set_led_pwm(50);
     opticalSensor2.set_led_pwm(50);
     while(true){
-        intake.move(127);
+        // The stall guard has the intake while it's backing out a jam
+        if(intake_guard.unjamming()){
+            pros::delay(ez::util::DELAY_TIME);
+            continue;
+        }
+        intake_guard.move(127);
         if((opticalSensor.get_hue()<=BLUE_HIGH&&opticalSensor.get_hue()>=BLUE_LOW&&opticalSensor.get_proximity()<100)||(opticalSensor2.get_hue()<=BLUE_HIGH&&opticalSensor2.get_hue()>=BLUE_LOW&&opticalSensor2.get_proximity()<100)){
-            intake.brake();
+            intake_guard.brake();
             pros::delay(100);
         }
         pros::delay(ez::util::DELAY_TIME);
@@ -22,9 +27,14 @@ void redsort(){
     opticalSensor.set_led_pwm(50);
     opticalSensor2.set_led_pwm(50);
     while(true){
-        intake.move(127);
+        // The stall guard has the intake while it's backing out a jam
+        if(intake_guard.unjamming()){
+            pros::delay(ez::util::DELAY_TIME);
+            continue;
+        }
+        intake_guard.move(127);
         if((opticalSensor.get_hue()<=RED_HIGH&&opticalSensor.get_hue()>=RED_LOW&&opticalSensor.get_proximity()<100)||(opticalSensor2.get_hue()<=RED_HIGH&&opticalSensor2.get_hue()>=RED_LOW&&opticalSensor2.get_proximity()<100)){
-            intake.brake();
+            intake_guard.brake();
             pros::delay(100);
         }
         pros::delay(ez::util::DELAY_TIME);
@@ -0,0 +1,60 @@
+#include "control_tick.hpp"
+
+#include <array>
+
+namespace ez {
+namespace control_tick {
+
+struct callback {
+  std::function<void()> function;
+  const char* name;
+  int period;
+  int timer;
+  uint32_t worst_us;
+};
+static std::array<callback, MAX_CALLBACKS> callbacks;
+static int callback_count = 0;
+static pros::Mutex callbacks_mutex;
+static pros::Task* tick_task = nullptr;
+
+static void tick() {
+  uint32_t now = pros::millis();
+  while (true) {
+    callbacks_mutex.take();
+    for (int i = 0; i < callback_count; i++) {
+      callback& current = callbacks[i];
+      current.timer -= util::DELAY_TIME;
+      if (current.timer > 0) continue;
+      current.timer = current.period;
+
+      uint64_t start = pros::micros();
+      current.function();
+      current.worst_us = std::max(current.worst_us, (uint32_t)(pros::micros() - start));
+    }
+    callbacks_mutex.give();
+    pros::Task::delay_until(&now, util::DELAY_TIME);
+  }
+}
+
+void add(std::function<void()> function, const char* name, int period) {
+  callbacks_mutex.take();
+  if (callback_count >= MAX_CALLBACKS) {
+    callbacks_mutex.give();
+    printf("Control Tick: only %i functions fit, %s wasn't added!\n", MAX_CALLBACKS, name);
+    return;
+  }
+  callbacks[callback_count++] = {function, name, std::max(period, util::DELAY_TIME), 0, 0};
+  callbacks_mutex.give();
+
+  if (tick_task == nullptr)
+    tick_task = new pros::Task(tick, "Control Tick");
+}
+
+void print() {
+  printf("Control tick:\n");
+  for (int i = 0; i < callback_count; i++)
+    printf("  %-24s every %3i ms, worst %5lu us\n", callbacks[i].name, callbacks[i].period, (unsigned long)callbacks[i].worst_us);
+}
+
+}  // namespace control_tick
+}  // namespace ez
@@ -0,0 +1,141 @@
+#include "controller_input.hpp"
+
+#include <bit>
+
+using namespace ez;
+
+// Buttons are stored as bits starting at L1
+static uint16_t button_bit(pros::controller_digital_e_t button) { return 1 << (button - pros::E_CONTROLLER_DIGITAL_L1); }
+
+static const char* EVENT_NAMES[] = {"press", "release", "hold", "double tap"};
+
+ControllerInput::ControllerInput(pros::Controller& controller) : controller(&controller) {}
+
+void ControllerInput::on(std::initializer_list<pros::controller_digital_e_t> buttons, input_event event, std::function<void()> function, const char* name) {
+  if (handler_count >= MAX_HANDLERS) {
+    printf("Controller Input: only %i handlers fit, %s wasn't added!\n", MAX_HANDLERS, name);
+    return;
+  }
+  uint16_t mask = 0;
+  for (auto button : buttons)
+    mask |= button_bit(button);
+
+  // Keep bigger combos first so they run before the buttons inside them
+  int i = handler_count++;
+  while (i > 0 && std::popcount(handlers[i - 1].mask) < std::popcount(mask)) {
+    handlers[i] = handlers[i - 1];
+    i--;
+  }
+  handlers[i] = {mask, event, function, name, false};
+}
+
+bool ControllerInput::event_happened(handler& input, uint32_t now) {
+  bool all_down = (down & input.mask) == input.mask;
+  switch (input.event) {
+    case PRESS:
+      return all_down && (just_pressed & input.mask);
+    case RELEASE:
+      return (last_down & input.mask) == input.mask && (just_released & input.mask);
+    case DOUBLE_TAP:
+      return all_down && (double_tapped & input.mask);
+    case HOLD: {
+      if (!all_down) {
+        input.hold_done = false;
+        return false;
+      }
+      if (input.hold_done) return false;
+      // The combo has been held since its last button went down
+      uint32_t latest = 0;
+      for (int i = 0; i < 12; i++)
+        if (input.mask & (1 << i)) latest = std::max(latest, press_time[i]);
+      input.hold_done = (int)(now - latest) >= hold_time;
+      return input.hold_done;
+    }
+  }
+  return false;
+}
+
+void ControllerInput::update() {
+  uint32_t now = pros::millis();
+
+  last_down = down;
+  down = 0;
+  for (int i = 0; i < 12; i++)
+    if (controller->get_digital((pros::controller_digital_e_t)(pros::E_CONTROLLER_DIGITAL_L1 + i))) down |= 1 << i;
+  for (int i = 0; i < 4; i++)
+    axes[i] = controller->get_analog((pros::controller_analog_e_t)i);
+
+  just_pressed = down & ~last_down;
+  just_released = last_down & ~down;
+  double_tapped = 0;
+  for (int i = 0; i < 12; i++) {
+    if (!(just_pressed & (1 << i))) continue;
+    press_time[i] = now;
+    // A third tap starts a new double tap instead of counting as another one
+    if (last_press_time[i] != 0 && (int)(now - last_press_time[i]) <= double_tap_time) {
+      double_tapped |= 1 << i;
+      last_press_time[i] = 0;
+    } else {
+      last_press_time[i] = now;
+    }
+  }
+
+  // A combo that runs stops handlers for fewer of its buttons
+  std::array<uint16_t, MAX_HANDLERS> ran;
+  int ran_count = 0;
+  for (int i = 0; i < handler_count; i++) {
+    handler& current = handlers[i];
+    if (!event_happened(current, now)) continue;
+
+    bool skip = false;
+    for (int j = 0; j < ran_count && !skip; j++)
+      skip = (ran[j] & current.mask) == current.mask && ran[j] != current.mask;
+    if (skip) continue;
+
+    ran[ran_count++] = current.mask;
+    current.function();
+  }
+}
+
+int ControllerInput::conflicts_print() {
+  auto buttons_print = [](uint16_t mask) {
+    static const char* NAMES[] = {"L1", "L2", "R1", "R2", "UP", "DOWN", "LEFT", "RIGHT", "X", "B", "Y", "A"};
+    bool first = true;
+    for (int i = 0; i < 12; i++) {
+      if (!(mask & (1 << i))) continue;
+      printf("%s%s", first ? "" : " + ", NAMES[i]);
+      first = false;
+    }
+  };
+
+  int conflicts = 0;
+  for (int i = 0; i < handler_count; i++) {
+    for (int j = i + 1; j < handler_count; j++) {
+      const handler& a = handlers[i];
+      const handler& b = handlers[j];
+      if (a.event != b.event || (a.mask & b.mask) != b.mask) continue;
+
+      printf("Controller Input: %s (", a.name);
+      buttons_print(a.mask);
+      printf(") and %s (", b.name);
+      buttons_print(b.mask);
+      printf(") share a %s, %s\n", EVENT_NAMES[a.event], a.mask == b.mask ? "both run" : "the combo wins");
+      conflicts++;
+    }
+  }
+  return conflicts;
+}
+
+bool ControllerInput::held(pros::controller_digital_e_t button) { return down & button_bit(button); }
+
+bool ControllerInput::pressed(pros::controller_digital_e_t button) { return just_pressed & button_bit(button); }
+
+bool ControllerInput::released(pros::controller_digital_e_t button) { return just_released & button_bit(button); }
+
+int ControllerInput::analog(pros::controller_analog_e_t axis) { return axes[axis]; }
+
+uint16_t ControllerInput::buttons_get() { return down; }
+
+void ControllerInput::hold_time_set(int time) { hold_time = time; }
+
+void ControllerInput::double_tap_time_set(int time) { double_tap_time = time; }
@@ -0,0 +1,160 @@
+#include "coprocessor.hpp"
+
+#include <cmath>
+#include <cstring>
+
+using namespace ez;
+
+static constexpr int TASK_DELAY = 2;
+
+Coprocessor::Coprocessor(int port, int baudrate) : serial(port), baudrate(baudrate) {}
+
+void Coprocessor::start() {
+  if (task != nullptr) return;
+  pros::c::serial_enable(serial.get_port());
+  serial.set_baudrate(baudrate);
+  serial.flush();
+  task = new pros::Task([this]() { task_run(); }, "Coprocessor");
+}
+
+void Coprocessor::odometry_set(Odometry& input, int period) {
+  odometry = &input;
+  pose_period = period;
+}
+
+bool Coprocessor::send(uint8_t type, const void* data, int length) {
+  if (length < 0 || length > MAX_PAYLOAD) {
+    printf("Coprocessor: %i bytes is too big to send!\n", length);
+    return false;
+  }
+  uint8_t encoded[MAX_PAYLOAD + FRAME_OVERHEAD + 4];
+  tx_mutex.take();
+  int encoded_length = frame_encode<MAX_PAYLOAD>(type, tx_sequence, data, length, encoded);
+
+  // Whole frames or nothing, half a frame would corrupt the next one too
+  if (!tx.push(encoded, encoded_length)) {
+    overflows++;
+    tx_mutex.give();
+    return false;
+  }
+  tx_sequence++;
+  sent++;
+  tx_mutex.give();
+  return true;
+}
+
+void Coprocessor::on(uint8_t type, std::function<void(const uint8_t* data, int length)> handler) {
+  if (type >= handlers.size()) {
+    printf("Coprocessor: message type %i can't have a handler!\n", type);
+    return;
+  }
+  handlers[type] = handler;
+}
+
+void Coprocessor::task_run() {
+  uint8_t chunk[64];
+  while (true) {
+    // Send as much as the port will take right now
+    tx_mutex.take();
+    int free = std::min((int)serial.get_write_free(), tx.used());
+    while (free > 0) {
+      int length = std::min(free, tx.contiguous());
+      int written = serial.write(tx.data.data() + tx.tail, length);
+      if (written <= 0) break;
+      tx.pop(written);
+      free -= written;
+    }
+    tx_mutex.give();
+
+    // Read whatever came in, a 0 ends a frame
+    int available = serial.get_read_avail();
+    while (available > 0) {
+      int length = serial.read(chunk, std::min(available, (int)sizeof(chunk)));
+      if (length <= 0) break;
+      available -= length;
+      for (int i = 0; i < length; i++) {
+        int frame_length = rx_frame.add(chunk[i]);
+        if (frame_length > 0)
+          frame_handle(rx_frame.data.data(), frame_length);
+        else if (frame_length < 0)
+          bad_frames++;
+      }
+    }
+    pros::delay(TASK_DELAY);
+  }
+}
+
+void Coprocessor::frame_handle(const uint8_t* encoded, int length) {
+  uint8_t raw[MAX_PAYLOAD + FRAME_OVERHEAD + 4];
+  int raw_length = frame_decode(encoded, length, raw);
+  if (raw_length < 0) {
+    bad_frames++;
+    return;
+  }
+
+  // Gaps in the sequence are frames that never made it
+  uint8_t type = raw[0], sequence = raw[1];
+  if (rx_started) dropped += (uint8_t)(sequence - rx_sequence);
+  rx_sequence = sequence + 1;
+  rx_started = true;
+  received++;
+  last_receive = pros::millis();
+
+  const uint8_t* payload = raw + 2;
+  int payload_length = raw_length - FRAME_OVERHEAD;
+  rx_mutex.take();
+  if (type == MSG_PATH && payload_length % sizeof(copro_point) == 0) {
+    path_length = payload_length / sizeof(copro_point);
+    memcpy(path.data(), payload, payload_length);
+    path_new = true;
+  } else if (type == MSG_CORRECTION && payload_length == sizeof(copro_pose)) {
+    memcpy(&correction, payload, sizeof(copro_pose));
+    correction_new = true;
+  }
+  rx_mutex.give();
+
+  if (type < handlers.size() && handlers[type]) handlers[type](payload, payload_length);
+}
+
+void Coprocessor::iterate() {
+  if (odometry == nullptr) return;
+
+  // Corrections are where the robot was at a time, so they're compared to odometry at that time with later corrections counted
+  rx_mutex.take();
+  bool has_correction = correction_new;
+  copro_pose latest = correction;
+  correction_new = false;
+  rx_mutex.give();
+  pose past;
+  if (has_correction && odometry->pose_at(latest.time, past))
+    odometry->correct(latest.x - past.x, latest.y - past.y);
+
+  pose_timer -= util::DELAY_TIME;
+  if (pose_timer > 0) return;
+  pose_timer = pose_period;
+  pose current = odometry->pose_get();
+  copro_pose message = {pros::millis(), (float)current.x, (float)current.y, (float)current.theta};
+  send(MSG_POSE, &message, sizeof(message));
+}
+
+bool Coprocessor::path_ready() { return path_new; }
+
+bool Coprocessor::path_take(std::vector<odom>& output, drive_directions dir, int speed) {
+  rx_mutex.take();
+  if (!path_new) {
+    rx_mutex.give();
+    return false;
+  }
+  output.clear();
+  for (int i = 0; i < path_length; i++)
+    output.push_back({{path[i].x, path[i].y, std::isnan(path[i].theta) ? ANGLE_NOT_SET : path[i].theta}, dir, speed});
+  path_new = false;
+  rx_mutex.give();
+  return true;
+}
+
+int Coprocessor::silence_get() { return rx_started ? pros::millis() - last_receive : -1; }
+
+void Coprocessor::print() {
+  printf("Coprocessor on port %i: %i sent, %i received, %i dropped, %i bad frames, %i send overflows\n", serial.get_port(), sent, received, dropped, bad_frames, overflows);
+}
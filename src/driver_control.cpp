@@ -0,0 +1,230 @@
+#include "driver_control.hpp"
+
+using namespace ez;
+
+/////
+//
+// Curve table
+//
+/////
+
+curve_table::curve_table() { scale_set(0.0); }
+
+void curve_table::scale_set(double input) {
+  scale = input;
+  for (int i = 0; i < 256; i++) {
+    double x = util::clamp(i - 128, 127, -127);
+    if (scale != 0)
+      table[i] = (powf(2.718, -(scale / 10)) + powf(2.718, (fabs(x) - 127) / 10) * (1 - powf(2.718, -(scale / 10)))) * x;
+    else
+      table[i] = x;
+  }
+}
+
+double curve_table::scale_get() { return scale; }
+
+void curve_table::points_set(std::vector<std::pair<double, double>> points) {
+  scale = -1;
+  if (points.empty() || points.front().first > 0.0) points.insert(points.begin(), {0.0, 0.0});
+  if (points.back().first < 127.0) points.push_back({127.0, 127.0});
+
+  std::size_t segment = 0;
+  for (int x = 0; x <= 128; x++) {
+    double input = fmin(x, 127);
+    while (segment < points.size() - 2 && input > points[segment + 1].first)
+      segment++;
+    auto [x0, y0] = points[segment];
+    auto [x1, y1] = points[segment + 1];
+    double output = x1 == x0 ? y1 : y0 + (y1 - y0) * (input - x0) / (x1 - x0);
+    output = util::clamp(output, 127);
+    table[(uint8_t)(x + 128)] = output;
+    table[(uint8_t)(128 - x)] = -output;
+  }
+}
+
+/////
+//
+// Driver control
+//
+/////
+
+DriverControl::DriverControl(Drive& drive, ControllerInput& input) : drive(&drive), input(&input) {}
+
+// Curves only change with the curve buttons or the SD card, so they're rebuilt when those change
+void DriverControl::curves_refresh() {
+  if (curves_custom) return;
+  if (curves_built && !drive->opcontrol_curve_buttons_toggle_get()) return;
+
+  // Curve buttons are slow to press, checking every 100ms is plenty
+  if (curves_built && curve_check_timer > 0) {
+    curve_check_timer -= util::DELAY_TIME;
+    return;
+  }
+  curve_check_timer = 100;
+
+  std::vector<double> scales = drive->opcontrol_curve_default_get();
+  if (left_curve.scale_get() != scales[0] || !curves_built) left_curve.scale_set(scales[0]);
+  if (right_curve.scale_get() != scales[1] || !curves_built) right_curve.scale_set(scales[1]);
+  curves_built = true;
+}
+
+void DriverControl::curve_custom_set(std::vector<std::pair<double, double>> left, std::vector<std::pair<double, double>> right) {
+  curves_custom = true;
+  left_curve.points_set(left);
+  right_curve.points_set(right.empty() ? left : right);
+}
+
+void DriverControl::curve_custom_clear() {
+  curves_custom = false;
+  curves_built = false;
+}
+
+void DriverControl::sides_set(double left, double right) {
+  // Scale both sides down together so turning isn't lost when the sticks add up past max speed
+  if (drive->opcontrol_arcade_scaling_enabled()) {
+    double max = drive->opcontrol_speed_max_get();
+    double faster_side = fmax(fabs(left), fabs(right));
+    if (faster_side > max) {
+      left *= max / faster_side;
+      right *= max / faster_side;
+    }
+  }
+  if (outputs == nullptr) {
+    drive->opcontrol_joystick_threshold_iterate(left, right);
+    return;
+  }
+
+  // This is opcontrol_joystick_threshold_iterate, with the motors set by the output stage
+  if (drive->drive_mode_get() != DISABLE)
+    drive->drive_mode_set(DISABLE, false);
+  if (drive->opcontrol_joystick_practicemode_toggle_get() && (fabs(left) > 120 || fabs(right) > 120)) {
+    left = 0;
+    right = 0;
+  }
+
+  int threshold = drive->opcontrol_joystick_threshold_get();
+  if (fabs(left) > threshold || fabs(right) > threshold) {
+    drive->left_activebrakePID.target_set(drive->drive_sensor_left());
+    drive->right_activebrakePID.target_set(drive->drive_sensor_right());
+    outputs->drive_set(left, right);
+  } else if (drive->opcontrol_drive_activebrake_get() != 0) {
+    outputs->drive_set(drive->left_activebrakePID.compute(drive->drive_sensor_left()), drive->right_activebrakePID.compute(drive->drive_sensor_right()));
+  } else {
+    outputs->drive_set(0, 0);
+  }
+}
+
+void DriverControl::outputs_set(OutputStage& input) { outputs = &input; }
+
+void DriverControl::arcade(e_type stick_type) {
+  drive->opcontrol_curve_buttons_iterate();
+  curves_refresh();
+
+  int fwd_raw = input->analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+  int turn_raw = stick_type == SPLIT ? input->analog(pros::E_CONTROLLER_ANALOG_RIGHT_X) : input->analog(pros::E_CONTROLLER_ANALOG_LEFT_X);
+  double fwd_stick = left_curve.get(fwd_raw);
+  double turn_stick = right_curve.get(turn_raw);
+
+  if (heading_hold)
+    turn_stick = heading_hold_iterate(fwd_stick, turn_stick, turn_raw);
+
+  // Take power out of forward and turning by priority instead of scaling both sides
+  if (turn_priority >= 0.0) {
+    double max = drive->opcontrol_speed_max_get();
+    double overflow = fabs(fwd_stick) + fabs(turn_stick) - max;
+    if (overflow > 0.0) {
+      double fwd_cut = fmin(fabs(fwd_stick), overflow * turn_priority + fmax(0.0, overflow * (1.0 - turn_priority) - fabs(turn_stick)));
+      fwd_stick -= util::sgn(fwd_stick) * fwd_cut;
+      double turn_cut = fmin(fabs(turn_stick), overflow - fwd_cut);
+      turn_stick -= util::sgn(turn_stick) * turn_cut;
+    }
+  }
+
+  double left = fwd_stick + turn_stick;
+  double right = fwd_stick - turn_stick;
+  if (max_slip > 0.0) {
+    left = traction_limit(left, drive->drive_velocity_left());
+    right = traction_limit(right, drive->drive_velocity_right());
+  }
+
+  sides_set(left, right);
+}
+
+/////
+//
+// Driver assist
+//
+/////
+
+void DriverControl::assist_heading_hold_set(bool enable) {
+  heading_hold = enable;
+  heading_holding = false;
+}
+
+bool DriverControl::assist_heading_hold_enabled() { return heading_hold; }
+
+void DriverControl::assist_heading_hold_delay_set(int time) { heading_hold_delay = time; }
+
+void DriverControl::assist_traction_set(double input) { max_slip = fabs(input); }
+
+double DriverControl::assist_traction_get() { return max_slip; }
+
+void DriverControl::assist_turn_priority_set(double priority) {
+  turn_priority = priority < 0.0 ? -1.0 : util::clamp(priority, 1.0, 0.0);
+  if (turn_priority >= 0.0)
+    drive->opcontrol_arcade_scaling(false);
+}
+
+double DriverControl::assist_turn_priority_get() { return turn_priority; }
+
+double DriverControl::heading_hold_iterate(double fwd_stick, double turn_stick, int turn_raw) {
+  int threshold = drive->opcontrol_joystick_threshold_get();
+
+  // The driver is turning, or the robot is sitting still and active brake has it
+  if (abs(turn_raw) > threshold || fabs(fwd_stick) <= threshold) {
+    heading_holding = false;
+    heading_hold_timer = 0;
+    return turn_stick;
+  }
+
+  // Let the robot stop rotating before locking the heading
+  if (!heading_holding) {
+    heading_hold_timer += util::DELAY_TIME;
+    if (heading_hold_timer < heading_hold_delay)
+      return turn_stick;
+    heading_holding = true;
+    heading_pid.constants_set(drive->headingPID.constants_get());
+    heading_pid.variables_reset();
+    heading_pid.target_set(drive->drive_imu_get(), drive->drive_imu_get());
+  }
+
+  // Derivative is on the heading, so bumps are damped without kicking when the hold starts
+  return heading_pid.compute(drive->drive_imu_get());
+}
+
+// Velocities are in rpm, so they're scaled to 127 with the cartridge's max rpm
+double DriverControl::traction_limit(double command, double velocity) {
+  if (max_rpm == 0.0)
+    max_rpm = drive_rpm_max(*drive);
+  double measured = velocity / max_rpm * 127.0;
+
+  // Only limit commands that speed the wheel up the way it's already going, braking and reversing go straight through
+  bool same_way = util::sgn(measured) == 0 || util::sgn(command) == util::sgn(measured);
+  if (!same_way || fabs(command) <= fabs(measured))
+    return command;
+  return util::clamp(command, measured + max_slip, measured - max_slip);
+}
+
+void DriverControl::tank() {
+  drive->opcontrol_curve_buttons_iterate();
+  curves_refresh();
+
+  // Tank uses the left curve for both sides, and isn't scaled like arcade
+  double left = left_curve.get(input->analog(pros::E_CONTROLLER_ANALOG_LEFT_Y));
+  double right = left_curve.get(input->analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y));
+  if (outputs == nullptr) {
+    drive->opcontrol_joystick_threshold_iterate(left, right);
+    return;
+  }
+  sides_set(left, right);
+}
@@ -0,0 +1,166 @@
+#include "field_view.hpp"
+
+#include <cmath>
+
+using namespace ez;
+
+static constexpr double FIELD_SIZE = 144.0;
+static constexpr double SCALE = FieldView::SIZE / FIELD_SIZE;
+static constexpr double TILE_SIZE = 24.0;
+// Corner of the robot's triangle, in inches from its middle
+static constexpr double ROBOT_RADIUS = 9.0;
+// Trail points further apart than this are a pose set, not driving, so they aren't joined
+static constexpr int TRAIL_JUMP = 8;
+
+// The canvas draws straight out of this, so it has to outlive every frame
+static uint8_t canvas_buffer[LV_CANVAS_BUF_SIZE_TRUE_COLOR(FieldView::SIZE, FieldView::SIZE)];
+
+static lv_point_t to_pixel(double x, double y) {
+  return {(lv_coord_t)util::clamp(std::round((x + FIELD_SIZE / 2.0) * SCALE), FieldView::SIZE - 1.0, 0.0),
+          (lv_coord_t)util::clamp(std::round((FIELD_SIZE / 2.0 - y) * SCALE), FieldView::SIZE - 1.0, 0.0)};
+}
+
+FieldView::FieldView(Odometry& odometry) : odometry(&odometry) {}
+
+void FieldView::start(int fps) {
+  if (task != nullptr) return;
+  period = 1000 / std::max(fps, 1);
+
+  canvas = lv_canvas_create(lv_layer_top());
+  lv_canvas_set_buffer(canvas, canvas_buffer, SIZE, SIZE, LV_IMG_CF_TRUE_COLOR);
+  lv_obj_align(canvas, LV_ALIGN_RIGHT_MID, -10, 0);
+  lv_obj_clear_flag(canvas, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+  background_draw();
+
+  path = lv_line_create(canvas);
+  lv_obj_set_style_line_width(path, 2, 0);
+  lv_obj_set_style_line_color(path, lv_color_hex(0xFFC000), 0);
+
+  robot = lv_line_create(canvas);
+  lv_obj_set_style_line_width(robot, 2, 0);
+  lv_obj_set_style_line_color(robot, lv_color_hex(0xFFFFFF), 0);
+
+  task = new pros::Task([this]() { task_run(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Field View");
+}
+
+void FieldView::visible_set(bool input) { visible = input; }
+
+bool FieldView::visible_get() { return visible; }
+
+void FieldView::plan_set(const std::vector<pose>& poses) {
+  plan_mutex.take();
+  plan = poses;
+  plan_new = true;
+  plan_mutex.give();
+}
+
+void FieldView::trail_clear() { clearing = true; }
+
+void FieldView::background_draw() {
+  lv_canvas_fill_bg(canvas, lv_color_hex(0x202020), LV_OPA_COVER);
+  lv_img_dsc_t* image = lv_canvas_get_img(canvas);
+  lv_color_t grid = lv_color_hex(0x505050);
+  for (double line = 0.0; line <= FIELD_SIZE; line += TILE_SIZE) {
+    lv_coord_t at = std::min((int)std::round(line * SCALE), SIZE - 1);
+    for (int i = 0; i < SIZE; i++) {
+      lv_img_buf_set_px_color(image, at, i, grid);
+      lv_img_buf_set_px_color(image, i, at, grid);
+    }
+  }
+  lv_obj_invalidate(canvas);
+}
+
+void FieldView::trail_draw(lv_point_t point) {
+  lv_img_dsc_t* image = lv_canvas_get_img(canvas);
+  lv_color_t color = lv_color_hex(0x00A0FF);
+  lv_point_t from = trail_last;
+  if (from.x < 0 || std::abs(point.x - from.x) > TRAIL_JUMP || std::abs(point.y - from.y) > TRAIL_JUMP)
+    from = point;
+
+  // Bresenham from the last point to this one
+  int dx = std::abs(point.x - from.x), dy = -std::abs(point.y - from.y);
+  int step_x = from.x < point.x ? 1 : -1, step_y = from.y < point.y ? 1 : -1;
+  int error = dx + dy;
+  lv_coord_t x = from.x, y = from.y;
+  while (true) {
+    lv_img_buf_set_px_color(image, x, y, color);
+    if (x == point.x && y == point.y) break;
+    int doubled = 2 * error;
+    if (doubled >= dy) {
+      error += dy;
+      x += step_x;
+    }
+    if (doubled <= dx) {
+      error += dx;
+      y += step_y;
+    }
+  }
+  trail_last = point;
+
+  // Only the pixels this segment touched get redrawn
+  if (!shown) return;
+  lv_area_t coords;
+  lv_obj_get_coords(canvas, &coords);
+  lv_area_t dirty = {(lv_coord_t)(coords.x1 + std::min(from.x, point.x)), (lv_coord_t)(coords.y1 + std::min(from.y, point.y)),
+                     (lv_coord_t)(coords.x1 + std::max(from.x, point.x)), (lv_coord_t)(coords.y1 + std::max(from.y, point.y))};
+  lv_obj_invalidate_area(canvas, &dirty);
+}
+
+void FieldView::robot_draw(pose current) {
+  // Skip frames where the robot wouldn't look any different
+  lv_point_t middle = to_pixel(current.x, current.y);
+  if (middle.x == robot_last.x && middle.y == robot_last.y && std::fabs(util::wrap_angle(current.theta - robot_angle)) < 3.0)
+    return;
+  robot_last = middle;
+  robot_angle = current.theta;
+
+  // A triangle pointing the way the robot faces, closed back on its first point
+  static constexpr double CORNERS[3] = {0.0, 140.0, -140.0};
+  for (int i = 0; i < 3; i++) {
+    double angle = util::to_rad(current.theta + CORNERS[i]);
+    robot_points[i] = to_pixel(current.x + ROBOT_RADIUS * sin(angle), current.y + ROBOT_RADIUS * cos(angle));
+  }
+  robot_points[3] = robot_points[0];
+  lv_line_set_points(robot, robot_points.data(), robot_points.size());
+}
+
+void FieldView::path_draw() {
+  int count = std::min((int)plan.size(), MAX_PLAN_POINTS);
+  for (int i = 0; i < count; i++)
+    path_points[i] = to_pixel(plan[i].x, plan[i].y);
+  lv_line_set_points(path, path_points.data(), count);
+  plan_new = false;
+}
+
+void FieldView::task_run() {
+  uint32_t now = pros::millis();
+  while (true) {
+    if (clearing) {
+      background_draw();
+      trail_last = {-1, -1};
+      clearing = false;
+    }
+
+    bool show = visible;
+    if (show != shown) {
+      if (show)
+        lv_obj_clear_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+      else
+        lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+      shown = show;
+    }
+
+    plan_mutex.take();
+    if (plan_new) path_draw();
+    plan_mutex.give();
+
+    // The trail keeps drawing while hidden, it's only redrawn on screen when showing
+    pose current = odometry->pose_get();
+    lv_point_t point = to_pixel(current.x, current.y);
+    if (point.x != trail_last.x || point.y != trail_last.y) trail_draw(point);
+    robot_draw(current);
+
+    pros::Task::delay_until(&now, period);
+  }
+}
@@ -0,0 +1,94 @@
+#include "gps_correction.hpp"
+
+#include <cmath>
+
+using namespace ez;
+
+static constexpr double METERS_TO_INCHES = 39.3701;
+
+GpsCorrection::GpsCorrection(int port, Odometry& odometry) : gps(port), odometry(&odometry) {}
+
+void GpsCorrection::offset_set(double x, double y) { gps.set_offset(x / METERS_TO_INCHES, y / METERS_TO_INCHES); }
+
+void GpsCorrection::frame_set(double x, double y, double rotation) { frame = {x, y, rotation}; }
+
+void GpsCorrection::error_max_set(double inches) { error_max = fabs(inches); }
+
+void GpsCorrection::gain_set(double input) { gain = util::clamp(input, 1.0, 0.0); }
+
+void GpsCorrection::jump_set(double inches, int agree_count) {
+  jump_distance = fabs(inches);
+  jump_agree = agree_count;
+}
+
+void GpsCorrection::latency_set(int ms) { latency = ms; }
+
+void GpsCorrection::enable(bool enable) { is_enabled = enable; }
+
+bool GpsCorrection::enabled() { return is_enabled; }
+
+void GpsCorrection::iterate() {
+  pros::gps_status_s_t status = gps.get_position_and_orientation();
+  double error = gps.get_error() * METERS_TO_INCHES;
+  if (!std::isfinite(status.x) || !std::isfinite(status.y)) return;
+
+  // The GPS updates slower than the tick, only new fixes count
+  if (status.x == last_x && status.y == last_y) return;
+  last_x = status.x;
+  last_y = status.y;
+  uint32_t time = pros::millis() - latency;
+
+  // Into odometry's coordinates
+  double angle = util::to_rad(frame.theta);
+  double gps_x = status.x * METERS_TO_INCHES;
+  double gps_y = status.y * METERS_TO_INCHES;
+  fix = {frame.x + gps_x * cos(angle) + gps_y * sin(angle),
+         frame.y - gps_x * sin(angle) + gps_y * cos(angle),
+         status.yaw};
+
+  if (!std::isfinite(error) || error > error_max) {
+    rejected++;
+    return;
+  }
+
+  // Compare to where odometry was when the fix was taken, the robot has moved since
+  pose past;
+  if (!odometry->pose_at(time, past)) {
+    rejected++;
+    return;
+  }
+  double difference_x = fix.x - past.x;
+  double difference_y = fix.y - past.y;
+
+  // Far fixes are held back until enough in a row land in the same place
+  if (hypot(difference_x, difference_y) > jump_distance) {
+    if (jump_count > 0 && hypot(difference_x - jump.x, difference_y - jump.y) > error_max * 2.0)
+      jump_count = 0;
+    jump = {difference_x, difference_y, 0.0};
+    if (++jump_count < jump_agree) {
+      rejected++;
+      return;
+    }
+    printf("GPS Correction: odometry was %.1f in off, moving to the GPS\n", hypot(difference_x, difference_y));
+    jump_count = 0;
+    accepted++;
+    if (is_enabled) odometry->correct(difference_x, difference_y);
+    return;
+  }
+  jump_count = 0;
+
+  // Better fixes correct more
+  double weight = gain * (1.0 - error / (error_max * 2.0));
+  accepted++;
+  if (is_enabled) odometry->correct(difference_x * weight, difference_y * weight);
+}
+
+pose GpsCorrection::fix_get() { return fix; }
+
+int GpsCorrection::accepted_get() { return accepted; }
+
+int GpsCorrection::rejected_get() { return rejected; }
+
+void GpsCorrection::print() {
+  printf("GPS correction: x %.2f  y %.2f  a %.1f  error %.2f in, %i fixes used, %i skipped\n", fix.x, fix.y, fix.theta, gps.get_error() * METERS_TO_INCHES, accepted, rejected);
+}
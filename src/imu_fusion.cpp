@@ -0,0 +1,206 @@
+#include "imu_fusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ez;
+
+// A change this big on the chassis' IMU alone is the heading being set, not a glitch
+static constexpr double JUMP_ANGLE = 20.0;
+static constexpr double MIN_VARIANCE = 0.0001;
+static constexpr int BIAS_TIME = 1000;
+// The chassis' IMU is only corrected after sitting still this long, so nothing is lost to a sample landing mid write
+static constexpr int STILL_TIME = 100;
+static constexpr double STILL_RATE = 1.0;
+
+ImuFusion::ImuFusion(Drive& drive) : drive(&drive) {
+  units[0] = {&drive.imu, 1.0, 0.0, MIN_VARIANCE, 0.0, 0.0, 0.0, 0, false, false};
+  count = 1;
+}
+
+void ImuFusion::imu_add(int port) {
+  if (count >= MAX_IMUS) {
+    printf("IMU Fusion: only %i IMUs fit, port %i wasn't added!\n", MAX_IMUS, port);
+    return;
+  }
+  // Units point into this, so it can't grow past what's reserved
+  extras.reserve(MAX_IMUS - 1);
+  extras.emplace_back(port);
+  units[count++] = {&extras.back(), 1.0, 0.0, MIN_VARIANCE, 0.0, 0.0, 0.0, 0, false, false};
+}
+
+int ImuFusion::imu_count() { return count; }
+
+void ImuFusion::calibrate_start() {
+  for (int i = 1; i < count; i++)
+    units[i].imu->reset(false);
+}
+
+bool ImuFusion::calibrate_finish(int timeout) {
+  int start = pros::millis();
+  auto calibrating = [this]() {
+    for (int i = 0; i < count; i++)
+      if (units[i].imu->is_calibrating()) return true;
+    return false;
+  };
+  while (calibrating() && (int)pros::millis() - start < timeout)
+    pros::delay(util::DELAY_TIME);
+
+  // Bias and noise are measured with the robot sitting still
+  std::array<double, MAX_IMUS> first, sum_squares = {};
+  for (int i = 0; i < count; i++)
+    first[i] = units[i].last = units[i].imu->get_rotation();
+  for (int tick = 0; tick < BIAS_TIME / util::DELAY_TIME; tick++) {
+    pros::delay(util::DELAY_TIME);
+    for (int i = 0; i < count; i++) {
+      double reading = units[i].imu->get_rotation();
+      sum_squares[i] += (reading - units[i].last) * (reading - units[i].last);
+      units[i].last = reading;
+    }
+  }
+
+  bool calibrated = true;
+  int ticks = BIAS_TIME / util::DELAY_TIME;
+  for (int i = 0; i < count; i++) {
+    unit& current = units[i];
+    current.valid = std::isfinite(current.last);
+    if (!current.valid) {
+      printf("IMU Fusion: IMU on port %i didn't calibrate!\n", current.imu->get_port());
+      calibrated = false;
+      continue;
+    }
+    current.bias = (current.last - first[i]) / ticks;
+    current.variance = std::max(sum_squares[i] / ticks - current.bias * current.bias, MIN_VARIANCE);
+  }
+  heading = drive->drive_imu_get();
+  ready = true;
+  return calibrated;
+}
+
+void ImuFusion::scale_set(int imu, double scale) {
+  if (imu < 0 || imu >= count) {
+    printf("IMU Fusion: IMU %i doesn't exist!\n", imu);
+    return;
+  }
+  if (imu == 0)
+    drive->drive_imu_scaler_set(scale);
+  else
+    units[imu].scale = scale;
+}
+
+double ImuFusion::scale_get(int imu) {
+  if (imu < 0 || imu >= count) return 0.0;
+  return imu == 0 ? drive->drive_imu_scaler_get() : units[imu].scale;
+}
+
+void ImuFusion::scale_calibrate_start() {
+  for (int i = 0; i < count; i++)
+    units[i].turned = 0.0;
+  calibrating_scale = true;
+}
+
+void ImuFusion::scale_calibrate_end(double degrees) {
+  calibrating_scale = false;
+  for (int i = 0; i < count; i++) {
+    if (fabs(units[i].turned) < 1.0) {
+      printf("IMU Fusion: IMU on port %i didn't turn, its scale wasn't changed!\n", units[i].imu->get_port());
+      continue;
+    }
+    scale_set(i, fabs(degrees / units[i].turned));
+    printf("IMU Fusion: IMU on port %i scale %.5f\n", units[i].imu->get_port(), scale_get(i));
+  }
+}
+
+void ImuFusion::outlier_set(double degrees) { outlier = fabs(degrees); }
+
+// Scaled change since last tick, NAN when the IMU isn't reporting
+double ImuFusion::read(unit& current) {
+  double reading = current.imu->get_rotation();
+  bool valid = std::isfinite(reading);
+  double delta = valid && current.valid ? reading - current.last - current.bias : NAN;
+  current.valid = valid;
+  if (valid) current.last = reading;
+  if (calibrating_scale && !std::isnan(delta)) current.turned += delta;
+  return delta;
+}
+
+void ImuFusion::iterate() {
+  units[0].scale = drive->drive_imu_scaler_get();
+  // Until calibration finishes this only follows the chassis' IMU
+  if (count == 1 || !ready) {
+    heading = drive->drive_imu_get();
+    active = 1;
+    return;
+  }
+
+  std::array<double, MAX_IMUS> sorted;
+  int valid_count = 0;
+  for (int i = 0; i < count; i++) {
+    units[i].delta = read(units[i]) * units[i].scale;
+    if (!std::isnan(units[i].delta)) sorted[valid_count++] = units[i].delta;
+  }
+
+  // With three or more IMUs the middle one is trusted, with two the last tick's change is
+  double reference = delta_last;
+  if (valid_count >= 3) {
+    std::sort(sorted.begin(), sorted.begin() + valid_count);
+    reference = valid_count % 2 ? sorted[valid_count / 2] : (sorted[valid_count / 2 - 1] + sorted[valid_count / 2]) / 2.0;
+  }
+
+  // The chassis' IMU jumping on its own means its heading was set, so follow it
+  bool heading_set = false;
+  if (!std::isnan(units[0].delta) && fabs(units[0].delta - reference) > outlier) {
+    bool others_agree = true;
+    for (int i = 1; i < count; i++)
+      if (!std::isnan(units[i].delta) && fabs(units[i].delta - reference) > outlier) others_agree = false;
+    heading_set = others_agree || fabs(units[0].delta) > JUMP_ANGLE;
+  }
+
+  double weighted = 0.0, weight_total = 0.0;
+  active = 0;
+  for (int i = 0; i < count; i++) {
+    unit& current = units[i];
+    current.used = !std::isnan(current.delta) && !(i == 0 && heading_set) && fabs(current.delta - reference) <= outlier;
+    if (!current.used) {
+      if (!std::isnan(current.delta) && !(i == 0 && heading_set)) current.rejections++;
+      continue;
+    }
+    weighted += current.delta / current.variance;
+    weight_total += 1.0 / current.variance;
+    active++;
+  }
+  double delta = weight_total > 0.0 ? weighted / weight_total : reference;
+
+  // Each IMU's weight follows how far it's been from the fused change
+  for (int i = 0; i < count; i++) {
+    unit& current = units[i];
+    if (!current.used) continue;
+    double error = current.delta - delta;
+    current.variance = std::max(current.variance + (error * error - current.variance) * 0.02, MIN_VARIANCE);
+  }
+
+  delta_last = delta;
+  heading = heading_set ? drive->drive_imu_get() : heading + delta;
+
+  // Hand the fused heading to the chassis' IMU once the robot is sitting still
+  still_time = fabs(delta) < STILL_RATE * util::DELAY_TIME / 1000.0 ? still_time + util::DELAY_TIME : 0;
+  if (still_time >= STILL_TIME && fabs(correction_get()) > 0.05 && std::isfinite(units[0].last)) {
+    double rotation = heading / units[0].scale;
+    drive->imu.set_rotation(rotation);
+    units[0].last = rotation;
+  }
+}
+
+double ImuFusion::heading_get() { return heading; }
+
+double ImuFusion::correction_get() { return heading - drive->drive_imu_get(); }
+
+int ImuFusion::active_get() { return active; }
+
+void ImuFusion::print() {
+  printf("IMU fusion: %.2f deg, %i of %i IMUs used\n", heading, active, count);
+  for (int i = 0; i < count; i++) {
+    const unit& current = units[i];
+    printf("  port %2i  scale %.5f  bias %+.4f deg/tick  weight %8.1f  left out %i times\n", current.imu->get_port(), current.scale, current.bias, 1.0 / current.variance, current.rejections);
+  }
+}
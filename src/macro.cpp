@@ -0,0 +1,290 @@
+#include "macro.hpp"
+
+#include <cmath>
+
+#include "fmt_buf.hpp"
+#include "motor_util.hpp"
+
+using namespace ez;
+
+MacroRecorder::MacroRecorder(Drive& drive, MotionRunner& runner) : drive(&drive), runner(&runner) {}
+
+/////
+//
+// Slots
+//
+/////
+
+void MacroRecorder::slots_add(std::vector<std::string> input) {
+  for (auto& name : input) {
+    if ((int)names.size() >= MAX_SLOTS) {
+      printf("Macro Recorder: only %i slots fit, %s wasn't added!\n", MAX_SLOTS, name.c_str());
+      break;
+    }
+    names.push_back(name);
+    slots.emplace_back();
+    sd_load(names.size() - 1);
+  }
+}
+
+void MacroRecorder::slot_set(int input) {
+  if (input < 0 || input >= (int)slots.size()) {
+    printf("Macro Recorder: slot %i doesn't exist!\n", input);
+    return;
+  }
+  slot = input;
+}
+
+void MacroRecorder::slot_next() {
+  if (slots.empty()) return;
+  slot = (slot + 1) % slots.size();
+}
+
+int MacroRecorder::slot_get() { return slot; }
+
+const char* MacroRecorder::slot_name_get() { return slots.empty() ? "" : names[slot].c_str(); }
+
+bool MacroRecorder::slot_recorded() { return !slots.empty() && slots[slot].point_count > 1; }
+
+void MacroRecorder::point_spacing_set(double distance) { spacing = fabs(distance); }
+
+/////
+//
+// Recording
+//
+/////
+
+void MacroRecorder::record_start(macro_anchor anchor) {
+  if (slots.empty() || is_replaying) return;
+  drive->odom_enable(true);
+  slots[slot].anchor = anchor;
+  slots[slot].point_count = 0;
+  slots[slot].event_count = 0;
+  start = drive->odom_pose_get();
+  last_dir = fwd;
+  is_recording = true;
+  point_add(start, fwd);
+}
+
+void MacroRecorder::record_stop() {
+  if (!is_recording) return;
+  point_add(drive->odom_pose_get(), last_dir);  // The last point has the heading the robot finished at
+  is_recording = false;
+  if (sd_save(slot))
+    printf("Macro Recorder: saved %s, %i points and %i events\n", names[slot].c_str(), slots[slot].point_count, slots[slot].event_count);
+}
+
+bool MacroRecorder::recording() { return is_recording; }
+
+void MacroRecorder::record_iterate() {
+  if (!is_recording) return;
+
+  pose current = drive->odom_pose_get();
+  double velocity = drive->drive_velocity_left() + drive->drive_velocity_right();
+  drive_directions dir = fabs(velocity) < 10.0 ? last_dir : (velocity > 0 ? fwd : rev);
+  double distance = util::distance_to_point(current, last);
+
+  // Paths can't reverse partway through, so a point goes where the robot changed direction
+  // Each point keeps the direction the robot drove to get there
+  if (distance >= spacing || (dir != last_dir && distance > 1.0))
+    point_add(current, last_dir);
+  last_dir = dir;
+}
+
+void MacroRecorder::event(int id, int value) {
+  if (!is_recording) return;
+  macro& current = slots[slot];
+  if (current.event_count >= current.events.size()) {
+    printf("Macro Recorder: %s is out of room for events!\n", names[slot].c_str());
+    return;
+  }
+
+  // Anchor the event to where the robot is, not the last point
+  pose now = drive->odom_pose_get();
+  if (util::distance_to_point(now, last) > 1.0)
+    point_add(now, last_dir);
+  current.events[current.event_count++] = {(uint16_t)(current.point_count - 1), (uint8_t)id, (int8_t)util::clamp(value, 127, -127)};
+}
+
+void MacroRecorder::point_add(pose current, drive_directions dir) {
+  macro& output = slots[slot];
+  if (output.point_count >= output.points.size()) {
+    printf("Macro Recorder: %s is out of room for points!\n", names[slot].c_str());
+    return;
+  }
+
+  double x = current.x, y = current.y, theta = current.theta;
+  if (output.anchor == MACRO_RELATIVE) {
+    double angle = util::to_rad(start.theta);
+    double dx = current.x - start.x, dy = current.y - start.y;
+    x = dx * cos(angle) - dy * sin(angle);
+    y = dx * sin(angle) + dy * cos(angle);
+    theta = current.theta - start.theta;
+  }
+
+  // Replay at about the speed the driver went
+  double rpm = fabs(drive->drive_velocity_left() + drive->drive_velocity_right()) / 2.0;
+  int speed = util::clamp(rpm / drive_rpm_max(*drive) * 127.0, 127, 40);
+
+  output.points[output.point_count++] = {(int16_t)lround(x * 100.0), (int16_t)lround(y * 100.0), (int16_t)lround(util::wrap_angle(theta) * 100.0), (uint8_t)dir, (uint8_t)speed};
+  last = current;
+}
+
+/////
+//
+// Replay
+//
+/////
+
+pose MacroRecorder::point_to_pose(const macro_point& point, const pose& origin) {
+  double x = point.x / 100.0, y = point.y / 100.0, theta = point.theta / 100.0;
+  double angle = util::to_rad(origin.theta);
+  return {origin.x + x * cos(angle) + y * sin(angle), origin.y - x * sin(angle) + y * cos(angle), origin.theta + theta};
+}
+
+// Turns the recording into a motion program, split into one path for each direction
+void MacroRecorder::program_build(const macro& input) {
+  pose origin = input.anchor == MACRO_RELATIVE ? drive->odom_pose_get() : pose{0.0, 0.0, 0.0};
+  program.clear();
+  program.reserve(input.point_count + input.event_count * 2 + 16);
+
+  // Relative macros start where the robot is, field macros have to drive to their start first
+  int first = input.anchor == MACRO_RELATIVE ? 1 : 0;
+  int event = 0;
+  for (; event < input.event_count && input.events[event].point < first; event++)
+    program.push_back(motion::actuator(input.events[event].id, input.events[event].value));
+
+  int segment_start = first;
+  while (segment_start < input.point_count) {
+    // The start of a field macro is driven to the same way as the point after it
+    drive_directions dir = (drive_directions)input.points[segment_start == 0 ? std::min(1, input.point_count - 1) : segment_start].dir;
+    int segment_end = segment_start;
+    while (segment_end + 1 < input.point_count && input.points[segment_end + 1].dir == dir)
+      segment_end++;
+
+    program.push_back(motion::odom_path(segment_end - segment_start + 1));
+    for (int i = segment_start; i <= segment_end; i++) {
+      pose target = point_to_pose(input.points[i], origin);
+      program.push_back(motion::path_point(target.x, target.y, dir, input.points[i].speed));
+    }
+    while (event < input.event_count && input.events[event].point <= segment_end) {
+      program.push_back(motion::wait_until_index(input.events[event].point - segment_start));
+      program.push_back(motion::actuator(input.events[event].id, input.events[event].value));
+      event++;
+    }
+    program.push_back(motion::wait());
+    segment_start = segment_end + 1;
+  }
+
+  // Finish facing the way the driver did
+  pose finish = point_to_pose(input.points[input.point_count - 1], origin);
+  program.push_back(motion::turn(finish.theta, 90, shortest));
+  program.push_back(motion::wait());
+}
+
+bool MacroRecorder::replay() {
+  if (!slot_recorded() || is_recording || is_replaying) return false;
+
+  program_build(slots[slot]);
+  if (runner->validate(program) != -1)
+    return false;
+
+  is_replaying = true;
+  pros::Task replay_task([this]() {
+    runner->run(program);
+    is_replaying = false;
+  });
+  return true;
+}
+
+bool MacroRecorder::replaying() { return is_replaying; }
+
+void MacroRecorder::replay_stop() {
+  if (is_replaying)
+    runner->stop();
+}
+
+/////
+//
+// SD card
+//
+/////
+
+// Header before the points and events in each macro file
+struct macro_header {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t anchor;
+  uint8_t reserved;
+  uint16_t point_count;
+  uint16_t event_count;
+  uint32_t checksum;
+};
+static constexpr uint32_t MACRO_MAGIC = 0x43414D45;  // "EMAC"
+static constexpr uint16_t MACRO_VERSION = 1;
+
+// FNV-1a over the recorded data
+static uint32_t macro_checksum(const macro& input) {
+  uint32_t hash = 2166136261u;
+  auto add = [&hash](const void* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+      hash ^= ((const uint8_t*)data)[i];
+      hash *= 16777619u;
+    }
+  };
+  add(input.points.data(), input.point_count * sizeof(macro_point));
+  add(input.events.data(), input.event_count * sizeof(macro_event));
+  return hash;
+}
+
+static fmt_buf<32> macro_path(int index) { return fmt_buf<32>("/usd/ez_macro_%i.bin", index); }
+
+bool MacroRecorder::sd_save(int index) {
+  if (!util::SD_CARD_ACTIVE) return false;
+
+  const macro& input = slots[index];
+  macro_header header = {MACRO_MAGIC, MACRO_VERSION, input.anchor, 0, input.point_count, input.event_count, macro_checksum(input)};
+  FILE* file = fopen(macro_path(index).c_str(), "wb");
+  if (file == nullptr) {
+    printf("Macro Recorder: couldn't save %s!\n", names[index].c_str());
+    return false;
+  }
+  fwrite(&header, sizeof(header), 1, file);
+  fwrite(input.points.data(), sizeof(macro_point), input.point_count, file);
+  fwrite(input.events.data(), sizeof(macro_event), input.event_count, file);
+  fclose(file);
+  return true;
+}
+
+bool MacroRecorder::sd_load(int index) {
+  if (!util::SD_CARD_ACTIVE) return false;
+
+  FILE* file = fopen(macro_path(index).c_str(), "rb");
+  if (file == nullptr) return false;
+
+  macro& output = slots[index];
+  macro_header header;
+  bool read = fread(&header, sizeof(header), 1, file) == 1 && header.magic == MACRO_MAGIC && header.version == MACRO_VERSION &&
+              header.point_count <= output.points.size() && header.event_count <= output.events.size();
+  if (read) {
+    read = fread(output.points.data(), sizeof(macro_point), header.point_count, file) == header.point_count &&
+           fread(output.events.data(), sizeof(macro_event), header.event_count, file) == header.event_count;
+  }
+  fclose(file);
+
+  // The header is only trusted once everything after it was read
+  output.point_count = 0;
+  output.event_count = 0;
+  if (!read) return false;
+
+  output.point_count = header.point_count;
+  output.event_count = header.event_count;
+  if (macro_checksum(output) != header.checksum) {
+    printf("Macro Recorder: %s is corrupted, clearing it\n", names[index].c_str());
+    output.point_count = 0;
+    output.event_count = 0;
+    return false;
+  }
+  output.anchor = (macro_anchor)header.anchor;
+  return true;
+}
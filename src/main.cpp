@@ -1,8 +1,13 @@
 #include "main.h"
 
 #include "autons.hpp"
+#include "control_tick.hpp"
+#include "controller_input.hpp"
+#include "driver_control.hpp"
 #include "pros/abstract_motor.hpp"
 #include "pros/misc.h"
+#include "screen_text.hpp"
+#include "startup.hpp"
 #include "subsystems.hpp"
 
 
@@ -29,6 +34,74 @@ ez::Drive chassis(
 // ez::tracking_wheel horiz_tracker(8, 2.75, 4.0);  // This tracking wheel is perpendicular to the drive wheels
 ez::tracking_wheel vert_tracker(-4, 2, 1.75);  // This tracking wheel is parallel to the drive wheels
 
+// Reads the controller once per loop and runs button handlers
+ez::ControllerInput controls(master);
+
+// Driver control with joystick curves precomputed into lookup tables
+ez::DriverControl driver(chassis, controls);
+
+/**
+ * Sets what every controller button does in opcontrol.
+ *
+ * Buttons that are held down, like the intake, are read in opcontrol.
+ */
+void controls_set() {
+  // Toggle pneumatics
+  controls.on({DIGITAL_UP}, ez::PRESS, []() {
+    mogoState = !mogoState;
+    outputs.piston_set(mogo, mogoState);
+    macros.event(MOGO, mogoState);
+  }, "mogo");
+  controls.on({DIGITAL_X}, ez::PRESS, []() {
+    doinkState = !doinkState;
+    outputs.piston_set(doink, doinkState);
+    macros.event(DOINK, doinkState);
+  }, "doink");
+  controls.on({DIGITAL_DOWN}, ez::PRESS, []() {
+    hangState = !hangState;
+    outputs.piston_set(hang, hangState);
+    macros.event(HANG, hangState);
+  }, "hang");
+
+  // PID Tuner and auton trigger, these only work when not connected to a competition switch
+  //  When the PID Tuner is enabled:
+  //  * use A and Y to increment / decrement the constants
+  //  * use the arrow keys to navigate the constants
+  controls.on({DIGITAL_X}, ez::PRESS, []() {
+    if (!pros::competition::is_connected())
+      chassis.pid_tuner_toggle();
+  }, "pid tuner");
+  controls.on({DIGITAL_B, DIGITAL_DOWN}, ez::PRESS, []() {
+    if (pros::competition::is_connected()) return;
+    pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
+    autonomous();
+    chassis.drive_brake_set(preference);
+    outputs.invalidate();  // The auton moved things without the output stage
+  }, "auton trigger");
+
+  // Macros, these are off while the PID Tuner is using the buttons
+  //  * Y selects the next macro slot
+  //  * LEFT starts and stops recording, only when not connected to a competition switch
+  //  * RIGHT replays the selected macro, moving a stick gives the drive back to you
+  controls.on({DIGITAL_Y}, ez::PRESS, []() {
+    if (chassis.pid_tuner_enabled()) return;
+    macros.slot_next();
+    master.print(0, 0, "%-15s", macros.slot_name_get());
+  }, "macro slot");
+  controls.on({DIGITAL_LEFT}, ez::PRESS, []() {
+    if (chassis.pid_tuner_enabled() || pros::competition::is_connected()) return;
+    if (macros.recording())
+      macros.record_stop();
+    else
+      macros.record_start();
+    master.rumble(macros.recording() ? "." : "..");
+  }, "macro record");
+  controls.on({DIGITAL_RIGHT}, ez::PRESS, []() {
+    if (!chassis.pid_tuner_enabled())
+      macros.replay();
+  }, "macro replay");
+}
+
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -38,8 +111,16 @@ ez::tracking_wheel vert_tracker(-4, 2, 1.75);  // This tracking wheel is paralle
 void initialize() {
   // Print our branding over your terminal :D
   ez::ez_template_print();
+  ez::startup::mark("branding");
+
+  // Extra IMUs are fused with the chassis' IMU for heading, they calibrate alongside it
+  // imu_fusion.imu_add(12);
+
+  // Calibrate the IMU in the background while everything else starts up
+  ez::startup::imu_calibrate_async(chassis, &imu_fusion);
 
   pros::delay(500);  // Stop the user from doing anything while legacy ports configure
+  ez::startup::mark("legacy ports");
 
   // Look at your horizontal tracking wheel and decide if it's in front of the midline of your robot or behind it
   //  - change `back` to `front` if the tracking wheel is in front of the midline
@@ -50,14 +131,83 @@ void initialize() {
   //  - ignore this if you aren't using a vertical tracker
   chassis.odom_tracker_right_set(&vert_tracker);
 
+  // Odometry sums whole tracker ticks so long runs don't drift from rounding
+  odometry.trackers_update();
+  odometry.imu_fusion_set(imu_fusion);
+  ez::control_tick::add([]() { imu_fusion.iterate(); }, "imu fusion");
+  // gps_correction.offset_set(0.0, -5.5);  // Where the GPS is on the robot in inches
+  // gps_correction.frame_set(0.0, 0.0);    // Odometry's coordinates of the middle of the field
+  // ez::control_tick::add([]() { gps_correction.iterate(); }, "gps correction");
+  ez::control_tick::add([]() { odometry.iterate(); }, "odometry");
+
+  // Vision signatures are set in the vision utility, these match them to field elements and their widths
+  vision.camera_set(0.0, 6.0);
+  vision.signature_add(1, TARGET_MOGO, 10.0);
+  vision.signature_add(2, TARGET_RED_RING, 7.0);
+  vision.signature_add(3, TARGET_BLUE_RING, 7.0);
+  ez::control_tick::add([]() { vision.iterate(); }, "vision", 20);
+
+  // The alliance partner needs the same id, and one of the two robots is the transmitter
+  // alliance.start("ez_alliance", true);
+  // alliance.loopback_set(true);  // Hears our own packets, for checking without a partner
+  ez::control_tick::add([]() { alliance.iterate(); }, "alliance link");
+
+  // coprocessor.odometry_set(odometry);
+  // coprocessor.start();
+  // ez::control_tick::add([]() { coprocessor.iterate(); }, "coprocessor");
+
+  // Field drawing for checking odometry drift, it only redraws what changed and runs below everything else
+  field_view.start();
+
   // Configure your chassis controls
   chassis.opcontrol_curve_buttons_toggle(false);   // Enables modifying the controller curve with buttons on the joysticks
   chassis.opcontrol_drive_activebrake_set(2.0);   // Sets the active brake kP. We recommend ~2.  0 will disable.
   chassis.opcontrol_curve_default_set(2.1, 4.3);  // Defaults for curve. If using tank, only the first parameter is used. (Comment this line out if you have an SD card!)
 
+  // Driver assists, these are all off by default
+  // driver.assist_heading_hold_set(true);  // Holds heading with the IMU when the turn stick is centered
+  // driver.assist_traction_set(40.0);      // Most a side can be commanded ahead of how fast it's going, out of 127.  0 will disable.
+  // driver.assist_turn_priority_set(0.5);  // Shares power between forward and turning when both are maxed out
+
   // Set the drive to your own constants from autons.cpp!
   default_constants();
 
+  // Give motion programs access to the arm, mogo, intake and color sort
+  motion_actuators_set();
+
+  // Slots for driver macros, anything saved on the SD card is loaded
+  macros.slots_add({"Mogo Grab", "Corner Clear"});
+
+  // The drive, intake and pistons go through the output stage, the arm runs itself on the control tick
+  outputs.drive_add(chassis);
+  outputs.motor_add(intake);
+  outputs.piston_add(mogo);
+  outputs.piston_add(doink);
+  outputs.piston_add(hang);
+  driver.outputs_set(outputs);
+
+  // PTO groups switch drive motors to a mechanism, ie lending the back motors to the arm for hang
+  // int hang_pto = pto.group_add({-6, 9}, hang);
+  // pto.role_set(hang_pto, ez::PTO_MECHANISM);
+  pto.outputs_set(outputs);
+
+  // Current limits follow what the robot is doing, and drop on motors that are heating up
+  power.drive_add();
+  power.motor_add(intake, ez::GROUP_INTAKE);
+  power.motor_add(arm, ez::GROUP_ARM);
+  power.total_set(18000);  // Less than the 8 motors can pull together, so priority moves current between them
+  ez::control_tick::add([]() { power.iterate(); }, "power budget", 100);
+
+  // The arm holds wherever it was last sent in every mode, it stays loose until then
+  ez::control_tick::add([]() { arm_mech.iterate(); }, "arm");
+
+  // Watch the intake for jams in every mode
+  ez::control_tick::add([]() { intake_guard.iterate(); }, "intake stall guard");
+
+  // Controller buttons, buttons used by more than one thing are printed
+  controls_set();
+  controls.conflicts_print();
+
   // These are already defaulted to these buttons, but you can change the left/right curve buttons here!
   // chassis.opcontrol_curve_buttons_left_set(pros::E_CONTROLLER_DIGITAL_LEFT, pros::E_CONTROLLER_DIGITAL_RIGHT);  // If using tank, only the left side is used.
   // chassis.opcontrol_curve_buttons_right_set(pros::E_CONTROLLER_DIGITAL_Y, pros::E_CONTROLLER_DIGITAL_A);
@@ -73,13 +223,21 @@ void initialize() {
       {"Color sort test for intaking red rings", redsort},
       {"Color sort test for intaking blue rings", bluesort},
       {"Auton skills run", skills},
+      {"Angular PID turn test\n\nTurns to 90, 45 and 0, then the long way to 90 and back with turn_pid.", angular_turn_example},
       {"Measure Offsets\n\nThis will turn the robot a bunch of times and calculate your offsets for your tracking wheels.", measure_offsets},
   });
 
   // Initialize chassis and auton selector
-  chassis.initialize();
+  //  - this is chassis.initialize() without the IMU calibration, that's already running
+  chassis.opcontrol_curve_sd_initialize();
+  chassis.drive_sensor_reset();
+  ez::startup::mark("chassis");
   ez::as::initialize();
-  master.rumble(chassis.drive_imu_calibrated() ? "." : "---");
+  ez::startup::selection_load(ez::as::auton_selector);
+  ez::startup::mark("auton selector");
+  auton_plan_selected();
+  ez::startup::mark("auton planned");
+  ez::startup::print();
 }
 
 /**
@@ -88,7 +246,11 @@ void initialize() {
  * the robot is enabled, this task will exit.
  */
 void disabled() {
-  // . . .
+  // Plan the selected auton so its paths are built before the match, not on the clock
+  while (true) {
+    auton_plan_selected();
+    pros::delay(ez::util::DELAY_TIME * 5);
+  }
 }
 
 /**
@@ -101,7 +263,11 @@ void disabled() {
  * starts.
  */
 void competition_initialize() {
-  // . . .
+  // Plan the selected auton so its paths are built before the match, not on the clock
+  while (true) {
+    auton_plan_selected();
+    pros::delay(ez::util::DELAY_TIME * 5);
+  }
 }
 
 /**
@@ -116,11 +282,14 @@ void competition_initialize() {
  * from where it left off.
  */
 void autonomous() {
+  ez::startup::imu_wait();                    // Make sure the IMU is done calibrating
   chassis.pid_targets_reset();                // Resets PID targets to 0
   chassis.drive_imu_reset();                  // Reset gyro position to 0
   chassis.drive_sensor_reset();               // Reset drive sensors to 0
-  chassis.odom_xyt_set(0_in, 0_in, 0_deg);    // Set the current position, you can start at a specific position with this
+  odometry.pose_set({0.0, 0.0, 0.0});         // Set the current position, you can start at a specific position with this
+  alliance.origin_clear();                    // Autons that start on field coordinates set this, until then the partner ignores our pose
   chassis.drive_brake_set(MOTOR_BRAKE_HOLD);  // Set motors to hold.  This helps autonomous consistency
+  power.priority_set(ez::BUDGET_DRIVE);       // The drive gets its full 2500 mA per motor, mechanisms get what's left
   mogo.set_value(0);
 
   /*
@@ -139,17 +308,18 @@ void autonomous() {
   ez::as::auton_selector.selected_auton_call();  // Calls selected auton from autonomous selector
 }
 
+// Brain screen text for the blank pages, only lines that changed are sent
+ez::ScreenText screen_text;
+
 /**
  * Simplifies printing tracker values to the brain screen
  */
-void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int line) {
-  std::string tracker_value = "", tracker_width = "";
+void screen_print_tracker(ez::tracking_wheel *tracker, const char *name, int line) {
   // Check if the tracker exists
-  if (tracker != nullptr) {
-    tracker_value = name + " tracker: " + util::to_string_with_precision(tracker->get());             // Make text for the tracker value
-    tracker_width = "  width: " + util::to_string_with_precision(tracker->distance_to_center_get());  // Make text for the distance to center
-  }
-  ez::screen_print(tracker_value + tracker_width, line);  // Print final tracker text
+  if (tracker != nullptr)
+    screen_text.print(line, "%s tracker: %.2f  width: %.2f", name, tracker->get(), tracker->distance_to_center_get());
+  else
+    screen_text.clear(line);
 }
 
 /**
@@ -158,34 +328,49 @@ void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int lin
  * and will help you debug problems you're having
  */
 void ez_screen_task() {
+  bool odom_page_last = false;
   while (true) {
     // Only run this when not connected to a competition switch
     if (!pros::competition::is_connected()) {
       // Blank page for odom debugging
       if (chassis.odom_enabled() && !chassis.pid_tuner_enabled()) {
         // If we're on the first blank page...
-        if (ez::as::page_blank_is_on(0)) {
+        bool odom_page = ez::as::page_blank_is_on(0);
+        if (odom_page && !odom_page_last)
+          screen_text.invalidate();  // The page was just opened, so everything on it has to be sent again
+        odom_page_last = odom_page;
+        if (odom_page && screen_text.due()) {
           // Display X, Y, and Theta
-          ez::screen_print("x: " + util::to_string_with_precision(chassis.odom_x_get()) +
-                               "\ny: " + util::to_string_with_precision(chassis.odom_y_get()) +
-                               "\na: " + util::to_string_with_precision(chassis.odom_theta_get()),
-                           1);  // Don't override the top Page line
+          screen_text.print(1, "x: %.2f", chassis.odom_x_get());  // Don't override the top Page line
+          screen_text.print(2, "y: %.2f", chassis.odom_y_get());
+          screen_text.print(3, "a: %.2f", chassis.odom_theta_get());
 
           // Display all trackers that are being used
           screen_print_tracker(chassis.odom_tracker_left, "l", 4);
           screen_print_tracker(chassis.odom_tracker_right, "r", 5);
           screen_print_tracker(chassis.odom_tracker_back, "b", 6);
           screen_print_tracker(chassis.odom_tracker_front, "f", 7);
+          screen_text.flush();
         }
+
+        // The second blank page shows the field, the planned auton and the odometry trail
+        field_view.visible_set(ez::as::page_blank_is_on(1));
+      } else {
+        odom_page_last = false;
+        field_view.visible_set(false);
       }
     }
 
     // Remove all blank pages when connected to a comp switch
     else {
+      field_view.visible_set(false);
       if (ez::as::page_blank_amount() > 0)
         ez::as::page_blank_remove_all();
     }
 
+    // Remember the selected auton across restarts
+    ez::startup::selection_update(ez::as::auton_selector);
+
     pros::delay(ez::util::DELAY_TIME);
   }
 }
@@ -197,6 +382,8 @@ pros::Task ezScreenTask(ez_screen_task);
  *   - to prevent this from accidentally happening at a competition, this
  *     is only enabled when you're not connected to competition control.
  * - gives you a GUI to change your PID values live by pressing X
+ *
+ * The buttons for these are set in controls_set().
  */
 void ez_template_extras() {
   // Only run this when not connected to a competition switch
@@ -204,20 +391,6 @@ void ez_template_extras() {
     // PID Tuner
     // - after you find values that you're happy with, you'll have to set them in auton.cpp
 
-    // Enable / Disable PID Tuner
-    //  When enabled:
-    //  * use A and Y to increment / decrement the constants
-    //  * use the arrow keys to navigate the constants
-    if (master.get_digital_new_press(DIGITAL_X))
-      chassis.pid_tuner_toggle();
-
-    // Trigger the selected autonomous routine
-    if (master.get_digital(DIGITAL_B) && master.get_digital(DIGITAL_DOWN)) {
-      pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
-      autonomous();
-      chassis.drive_brake_set(preference);
-    }
-
     // Allow PID Tuner to iterate
     chassis.pid_tuner_iterate();
   }
@@ -229,6 +402,23 @@ void ez_template_extras() {
   }
 }
 
+/**
+ * Records and replays driver macros, the buttons for these are set in controls_set().
+ */
+void macro_controls() {
+  // Moving a stick takes the drive back from a replay
+  if (macros.replaying() && (abs(controls.analog(ANALOG_LEFT_Y)) > 20 || abs(controls.analog(ANALOG_RIGHT_X)) > 20))
+    macros.replay_stop();
+
+  // The replay moved things without the output stage
+  static bool was_replaying = false;
+  if (was_replaying && !macros.replaying())
+    outputs.invalidate();
+  was_replaying = macros.replaying();
+
+  macros.record_iterate();
+}
+
 /**
  * Runs the operator control code. This function will be started in its own task
  * with the default priority and stack size whenever the robot is enabled via
@@ -243,52 +433,77 @@ void ez_template_extras() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
+  ez::startup::imu_wait();  // Make sure the IMU is done calibrating
+
   // This is preference to what you like to drive on
   chassis.drive_brake_set(MOTOR_BRAKE_COAST);
   arm.set_brake_mode(pros::MotorBrake::coast);
   intake.set_brake_mode(pros::MotorBrake::coast);
 
+  // Autonomous may have moved things the output stage doesn't know about
+  outputs.invalidate();
+
+  // Macros only record intake and arm changes
+  int last_intake_speed = 0;
+  int last_arm_speed = 0;
+
   while (true) {
+    // Read the controller and run button handlers
+    controls.update();
+
     // Gives you some extras to make EZ-Template ezier
     ez_template_extras();
 
-    // chassis.opcontrol_tank();  // Tank control
-    chassis.opcontrol_arcade_standard(ez::SPLIT);  // Standard split arcade
-    // chassis.opcontrol_arcade_standard(ez::SINGLE);  // Standard single arcade
-    // chassis.opcontrol_arcade_flipped(ez::SPLIT);    // Flipped split arcade
-    // chassis.opcontrol_arcade_flipped(ez::SINGLE);   // Flipped single arcade
-
-    // . . .
-    // Put more user control code here!
-    // . . .
-
-    if (master.get_digital(DIGITAL_L1)) {
-      intake.move(127);
-    } else if (master.get_digital(DIGITAL_R1)) {
-      intake.move(-127);
-    } else {
-      intake.move(0);
-    }
-    if (master.get_digital(DIGITAL_L2)) {
-      arm.move(127);
-    } else if (master.get_digital(DIGITAL_R2)) {
-      arm.move(-127);
-    } else {
-      arm.move(0);
+    // Record and replay macros
+    macro_controls();
+
+    // The macro has the drive and intake while it replays
+    if (!macros.replaying()) {
+      // driver.tank();  // Tank control
+      driver.arcade(ez::SPLIT);  // Standard split arcade
+      // driver.arcade(ez::SINGLE);  // Standard single arcade
+      // chassis.opcontrol_arcade_flipped(ez::SPLIT);    // Flipped split arcade
+      // chassis.opcontrol_arcade_flipped(ez::SINGLE);   // Flipped single arcade
+
+      // . . .
+      // Put more user control code here!
+      // . . .
+
+      int intake_speed = 0;
+      if (controls.held(DIGITAL_L1)) {
+        intake_speed = 127;
+      } else if (controls.held(DIGITAL_R1)) {
+        intake_speed = -127;
+      }
+      intake_guard.command_set(intake_speed);  // The guard goes back to this after a jam
+      if (!intake_guard.unjamming())
+        outputs.motor_set(intake, intake_speed);
+      if (intake_speed != last_intake_speed)
+        macros.event(INTAKE, intake_speed);
+      last_intake_speed = intake_speed;
+
+      int arm_speed = 0;
+      if (controls.held(DIGITAL_L2)) {
+        arm_speed = 127;
+      } else if (controls.held(DIGITAL_R2)) {
+        arm_speed = -127;
+      }
+      arm_mech.manual(arm_speed);
+      if (arm_speed != last_arm_speed)
+        macros.event(ARM, arm_speed);
+      last_arm_speed = arm_speed;
+
+      // Give current to whatever is scoring, otherwise to the drive
+      if (arm_speed != 0)
+        power.priority_set(ez::BUDGET_ARM);
+      else if (intake_speed != 0 && abs(controls.analog(ANALOG_LEFT_Y)) < 30)
+        power.priority_set(ez::BUDGET_INTAKE);
+      else
+        power.priority_set(ez::BUDGET_DRIVE);
     }
 
-    if (master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_UP)) {
-      mogoState = !mogoState;
-      mogo.set_value(mogoState);
-    }
-    if (master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_X)) {
-      doinkState = !doinkState;
-      doink.set_value(doinkState);
-    }
-    if (master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)) {
-      hangState = !hangState;
-      hang.set_value(hangState);
-    }
+    // Send every motor and piston command from this loop at once
+    outputs.flush();
 
     pros::delay(ez::util::DELAY_TIME);  // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
   }
@@ -0,0 +1,135 @@
+#include "mechanism.hpp"
+
+#include <cmath>
+
+using namespace ez;
+
+Mechanism::Mechanism(std::vector<pros::Motor> input) : motors(input) {}
+
+Mechanism::Mechanism(pros::Motor motor) : motors({motor}) {}
+
+void Mechanism::ratio_set(double input) { ratio = input; }
+
+void Mechanism::constants_set(double p, double i, double d, double start_i) { pid.constants_set(p, i, d, start_i); }
+
+void Mechanism::exit_condition_set(int small_exit_time, double small_error, int big_exit_time, double big_error, int velocity_exit_time, int mA_timeout) {
+  pid.exit_condition_set(small_exit_time, small_error, big_exit_time, big_error, velocity_exit_time, mA_timeout);
+}
+
+void Mechanism::profile_set(double input_velocity, double input_acceleration) {
+  max_velocity = fabs(input_velocity);
+  acceleration = fabs(input_acceleration);
+}
+
+void Mechanism::feedforward_set(double input_kg, double input_level_angle, double input_kv) {
+  kg = input_kg;
+  level_angle = input_level_angle;
+  kv = input_kv;
+}
+
+void Mechanism::preset_set(int id, const char* name, double angle) {
+  if (id < 0 || id >= MAX_PRESETS) {
+    printf("Mechanism: preset %i is out of range!\n", id);
+    return;
+  }
+  presets[id] = {name, angle};
+}
+
+double Mechanism::angle_get() { return motors.front().get_position() / ratio - offset; }
+
+void Mechanism::angle_set(double angle) {
+  offset = motors.front().get_position() / ratio - angle;
+  target = setpoint = angle;
+  setpoint_velocity = 0.0;
+  profile_done = true;
+}
+
+double Mechanism::target_get() { return target; }
+
+int Mechanism::preset_get() { return preset_id; }
+
+// The profile starts from where the setpoint is, so new targets don't jump
+void Mechanism::target_start(double angle) {
+  if (manual_active) {
+    setpoint = angle_get();
+    setpoint_velocity = 0.0;
+    manual_active = false;
+  }
+  target = angle;
+  profile_done = false;
+  exit = RUNNING;
+  pid.variables_reset();
+}
+
+void Mechanism::move_to(int preset) {
+  if (preset < 0 || preset >= MAX_PRESETS || presets[preset].name == nullptr) {
+    printf("Mechanism: preset %i isn't set!\n", preset);
+    return;
+  }
+  target_start(presets[preset].angle);
+  preset_id = preset;
+}
+
+void Mechanism::move_to_angle(double angle) {
+  target_start(angle);
+  preset_id = -1;
+}
+
+void Mechanism::manual(int voltage) {
+  // Letting go holds wherever the mechanism stopped
+  if (voltage == 0) {
+    if (manual_active) move_to_angle(angle_get());
+    return;
+  }
+  manual_active = true;
+  manual_voltage = voltage;
+  preset_id = -1;
+}
+
+void Mechanism::iterate() {
+  double angle = angle_get();
+  double gravity = kg * cos(util::to_rad(angle - level_angle));
+
+  if (manual_active) {
+    for (auto& motor : motors)
+      motor.move(manual_voltage);
+    return;
+  }
+
+  // Trapezoidal profile, the fastest speed that can still stop at the target is the cap
+  if (!profile_done) {
+    double dt = util::DELAY_TIME / 1000.0;
+    double remaining = target - setpoint;
+    double stop_velocity = sqrt(2.0 * acceleration * fabs(remaining));
+    double wanted = util::sgn(remaining) * fmin(max_velocity, stop_velocity);
+    setpoint_velocity += util::clamp(wanted - setpoint_velocity, acceleration * dt, -acceleration * dt);
+    setpoint += setpoint_velocity * dt;
+    if (fabs(target - setpoint) < 0.5 && fabs(setpoint_velocity) <= acceleration * dt) {
+      setpoint = target;
+      setpoint_velocity = 0.0;
+      profile_done = true;
+    }
+  }
+
+  pid.target_set(setpoint);
+  double output = pid.compute(angle) + gravity + kv * setpoint_velocity;
+  for (auto& motor : motors)
+    motor.move(util::clamp(output, 127, -127));
+
+  // Exit conditions only start once the profile is at the target
+  if (profile_done && exit == RUNNING)
+    exit = pid.exit_condition(motors.front());
+}
+
+exit_output Mechanism::exit_get() { return manual_active ? RUNNING : exit; }
+
+void Mechanism::wait() {
+  while (!manual_active && exit == RUNNING)
+    pros::delay(util::DELAY_TIME);
+}
+
+void Mechanism::wait_until(double angle) {
+  int direction = util::sgn(angle - angle_get());
+  while (!manual_active && exit == RUNNING && util::sgn(angle - angle_get()) == direction)
+    pros::delay(util::DELAY_TIME);
+}
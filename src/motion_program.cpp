@@ -0,0 +1,563 @@
+#include "motion_program.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace ez;
+
+MotionRunner::MotionRunner(Drive& drive) : drive(&drive) {}
+
+void MotionRunner::actuator_add(int id, std::function<void(int value, bool mirrored)> actuator) {
+  if (id < 0 || id >= MAX_IDS) {
+    printf("Motion Runner: actuator id %i is out of range!\n", id);
+    return;
+  }
+  actuators[id] = actuator;
+}
+
+void MotionRunner::trigger_add(int id, std::function<bool()> condition) {
+  if (id < 0 || id >= MAX_IDS) {
+    printf("Motion Runner: trigger id %i is out of range!\n", id);
+    return;
+  }
+  triggers[id] = condition;
+}
+
+void MotionRunner::snap_set(std::function<bool(int kind, bool mirrored, double radius, double& x, double& y)> snap) { snapper = snap; }
+
+// Snapped steps go to the detected element if there's one close enough
+pose MotionRunner::target_get(const motion_step& step) {
+  pose target = {step.x, step.y, step.theta};
+  if (step.id > 0 && snapper && snapper(step.id - 1, step.mirrored, step.arg, target.x, target.y)) {
+    printf("Motion Runner: snapped (%.2f, %.2f) to (%.2f, %.2f)\n", step.x, step.y, target.x, target.y);
+    off_plan = true;
+  }
+  return target;
+}
+
+// Ops that move the robot need a speed the motors can actually run at
+static bool op_uses_speed(motion_op op) {
+  switch (op) {
+    case OP_DRIVE:
+    case OP_ODOM_DRIVE:
+    case OP_TURN:
+    case OP_TURN_TO_POINT:
+    case OP_SWING:
+    case OP_ODOM_MOVE:
+    case OP_PATH_POINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int MotionRunner::validate(std::span<const motion_step> program, bool print) {
+  int path_points_left = 0;
+  for (int i = 0; i < (int)program.size(); i++) {
+    const motion_step& step = program[i];
+    const char* error = nullptr;
+
+    if (!std::isfinite(step.x) || !std::isfinite(step.y) || !std::isfinite(step.theta))
+      error = "value is not a number";
+    else if (op_uses_speed(step.op) && (step.speed <= 0 || step.speed > 127))
+      error = "speed must be between 1 and 127";
+    else if (path_points_left > 0 && step.op != OP_PATH_POINT)
+      error = "path ended before all of its points";
+    else if (path_points_left == 0 && step.op == OP_PATH_POINT)
+      error = "path point is not part of a path";
+    else if (step.op == OP_ODOM_PATH && step.arg <= 0)
+      error = "path needs at least 1 point";
+    else if (step.op == OP_SWING && (step.arg < 0 || step.arg > 127))
+      error = "opposite speed must be between 0 and 127";
+    else if ((step.op == OP_DELAY || step.op == OP_TRIGGER) && step.arg < 0)
+      error = "time can't be negative";
+    else if (step.op == OP_WAIT_INDEX && step.arg < 0)
+      error = "path index can't be negative";
+    else if (step.op == OP_ACTUATOR && (step.id < 0 || step.id >= MAX_IDS || !actuators[step.id]))
+      error = "actuator is not registered";
+    else if ((step.op == OP_TRIGGER || step.op == OP_SKIP_IF) && (step.id < 0 || step.id >= MAX_IDS || !triggers[step.id]))
+      error = "trigger is not registered";
+    else if (step.op == OP_SKIP_IF && (step.arg < 0 || i + step.arg >= (int)program.size()))
+      error = "skip goes past the end of the program";
+    else if (step.op == OP_SKIP_IF && i + step.arg + 1 < (int)program.size() && program[i + step.arg + 1].op == OP_PATH_POINT)
+      error = "skip lands inside a path";
+    else if ((step.op == OP_TURN_TO_POINT || step.op == OP_ODOM_MOVE) && step.id > 0 && !snapper)
+      error = "snap function is not set";
+    else if (step.op > OP_SKIP_IF)
+      error = "unknown opcode";
+
+    if (error != nullptr) {
+      if (print) printf("Motion Runner: step %i (op %i) is invalid, %s!\n", i, step.op, error);
+      return i;
+    }
+
+    if (step.op == OP_ODOM_PATH)
+      path_points_left = step.arg;
+    else if (step.op == OP_PATH_POINT)
+      path_points_left--;
+    else if (step.op == OP_END)
+      return -1;
+  }
+
+  if (path_points_left > 0) {
+    if (print) printf("Motion Runner: program ended before all path points!\n");
+    return program.size() - 1;
+  }
+  return -1;
+}
+
+void MotionRunner::path_build(std::span<const motion_step> program, std::size_t index, std::vector<odom>& output) {
+  output.clear();
+  output.reserve(program[index].arg);
+  for (int j = 1; j <= program[index].arg; j++) {
+    const motion_step& point = program[index + j];
+    odom movement = {{point.x, point.y, point.theta}, point.dir, point.speed};
+    if (point.behavior_set) movement.turn_behavior = point.behavior;
+    output.push_back(movement);
+  }
+}
+
+// Does what EZ-Template's pid_odom_set does to a path, starting from where the plan has the robot instead of where it is
+void MotionRunner::path_prepare(pose start, planned_path& path) {
+  std::vector<odom> input = path.points;
+  input.insert(input.begin(), {{start.x, start.y, ANGLE_NOT_SET}, input[0].drive_direction, input[0].max_xy_speed});
+
+  // Points every spacing along each line, with the speed and direction of the point the line goes to
+  double spacing = drive->odom_path_spacing_get();
+  std::vector<odom> injected;
+  path.indexes.clear();
+  for (std::size_t i = 0; i + 1 < input.size(); i++) {
+    if (i > 0) path.indexes.push_back(injected.size());
+    injected.push_back(input[i]);
+    pose from = input[i].target, to = input[i + 1].target;
+    double angle = util::absolute_angle_to_point(to, from);
+    int count = spacing > 0.0 ? (int)ceil(util::distance_to_point(to, from) / spacing) : 1;
+    for (int j = 1; j < count; j++) {
+      odom movement = input[i + 1];
+      movement.target = util::vector_off_point(spacing * j, {from.x, from.y, angle});
+      movement.target.theta = ANGLE_NOT_SET;
+      injected.push_back(movement);
+    }
+  }
+  path.indexes.push_back(injected.size());
+  injected.push_back(input.back());
+
+  // Gradient descent smoothing, the ends and any point with a heading to reach stay where they are
+  std::vector<double> constants = drive->odom_path_smooth_constants_get();
+  double weight_smooth = constants[0], weight_data = constants[1], tolerance = constants[2];
+  std::vector<odom> smoothed = injected;
+  double change = tolerance;
+  for (int pass = 0; pass < 1000 && tolerance > 0.0 && change >= tolerance; pass++) {
+    change = 0.0;
+    for (std::size_t i = 1; i + 1 < smoothed.size(); i++) {
+      if (injected[i].target.theta != ANGLE_NOT_SET) continue;
+      pose& point = smoothed[i].target;
+      double x = point.x, y = point.y;
+      point.x += weight_data * (injected[i].target.x - point.x) + weight_smooth * (smoothed[i - 1].target.x + smoothed[i + 1].target.x - 2.0 * point.x);
+      point.y += weight_data * (injected[i].target.y - point.y) + weight_smooth * (smoothed[i - 1].target.y + smoothed[i + 1].target.y - 2.0 * point.y);
+      change += fabs(point.x - x) + fabs(point.y - y);
+    }
+  }
+  path.points = smoothed;
+}
+
+bool MotionRunner::run(std::span<const motion_step> program) {
+  bool use_plan = planned(program);
+  if (!use_plan && validate(program) != -1)
+    return false;
+
+  stopping = false;
+  off_plan = false;
+  int path_count = 0;
+  const std::vector<int>* path_indexes = nullptr;
+  for (std::size_t i = 0; i < program.size(); i++) {
+    const motion_step& step = program[i];
+    current_step = i;
+    if (stopping)
+      break;
+    if (step.op == OP_END)
+      break;
+
+    // Skipped steps are jumped over, paths inside them still count so planned paths line up.
+    // The plan assumed nothing is skipped, so the paths after this start somewhere else
+    if (step.op == OP_SKIP_IF) {
+      if (triggers[step.id]()) {
+        for (std::size_t j = i + 1; j <= i + step.arg; j++)
+          if (program[j].op == OP_ODOM_PATH) path_count++;
+        i += step.arg;
+        off_plan = true;
+      }
+      continue;
+    }
+
+    // Paths are the only multi step op, run the planned points or gather the points that follow
+    if (step.op == OP_ODOM_PATH) {
+      if (use_plan && !off_plan && !planned_paths[path_count].points.empty()) {
+        drive->pid_odom_pp_set(planned_paths[path_count].points, step.slew);
+        path_indexes = &planned_paths[path_count].indexes;
+      } else {
+        path_build(program, i, path_buffer);
+        drive->pid_odom_set(path_buffer, step.slew);
+        path_indexes = nullptr;
+      }
+      path_count++;
+      i += step.arg;
+      continue;
+    }
+
+    // Planned paths have injected points, so the program's point index is moved to where that point landed
+    if (step.op == OP_WAIT_INDEX && path_indexes != nullptr) {
+      drive->pid_wait_until_index((*path_indexes)[std::min(step.arg, (int)path_indexes->size() - 1)]);
+      continue;
+    }
+
+    step_run(step);
+  }
+  current_step = -1;
+  return !stopping;
+}
+
+int MotionRunner::step_get() { return current_step; }
+
+void MotionRunner::stop() {
+  stopping = true;
+  drive->drive_mode_set(DISABLE);
+}
+
+bool MotionRunner::plan(std::span<const motion_step> program) {
+  plan_clear();
+  if (validate(program) != -1)
+    return false;
+
+  planned_poses.resize(program.size());
+  pose current = {0.0, 0.0, 0.0};
+  bool start_known = false;
+  for (std::size_t i = 0; i < program.size(); i++) {
+    const motion_step& step = program[i];
+    if (step.op == OP_END) {
+      planned_poses.resize(i);
+      break;
+    }
+
+    switch (step.op) {
+      case OP_POSE_SET:
+        current = {step.x, step.y, step.theta};
+        start_known = true;
+        break;
+
+      case OP_DRIVE:
+      case OP_ODOM_DRIVE: {
+        pose next = util::vector_off_point(step.x, current);
+        current = {next.x, next.y, current.theta};
+        planned_distance += fabs(step.x);
+        break;
+      }
+
+      case OP_TURN:
+      case OP_SWING:
+        current.theta = step.theta;
+        break;
+
+      case OP_TURN_TO_POINT: {
+        double angle = util::absolute_angle_to_point({step.x, step.y}, current);
+        current.theta = util::wrap_angle(step.dir == rev ? angle + 180.0 : angle);
+        break;
+      }
+
+      case OP_ODOM_MOVE:
+        planned_distance += util::distance_to_point({step.x, step.y}, current);
+        current = {step.x, step.y, step.theta != CONSTEXPR_ANGLE_NOT_SET ? step.theta : current.theta};
+        break;
+
+      case OP_ODOM_PATH: {
+        // Without a pose_set the robot could start anywhere, so the path is built when it runs
+        planned_paths.emplace_back();
+        if (start_known) {
+          path_build(program, i, planned_paths.back().points);
+          path_prepare(current, planned_paths.back());
+        }
+        for (int j = 1; j <= step.arg; j++) {
+          const motion_step& point = program[i + j];
+          planned_distance += util::distance_to_point({point.x, point.y}, current);
+          current = {point.x, point.y, point.theta != CONSTEXPR_ANGLE_NOT_SET ? point.theta : current.theta};
+          planned_poses[i + j] = current;
+        }
+        planned_poses[i] = current;
+        i += step.arg;
+        continue;
+      }
+
+      default:
+        break;
+    }
+    planned_poses[i] = current;
+  }
+
+  planned_program = program;
+  return true;
+}
+
+bool MotionRunner::planned(std::span<const motion_step> program) {
+  return planned_program.data() != nullptr && program.data() == planned_program.data() && program.size() == planned_program.size();
+}
+
+void MotionRunner::plan_clear() {
+  planned_program = {};
+  planned_paths.clear();
+  planned_poses.clear();
+  planned_distance = 0.0;
+}
+
+const std::vector<pose>& MotionRunner::plan_poses_get() { return planned_poses; }
+
+double MotionRunner::plan_distance_get() { return planned_distance; }
+
+void MotionRunner::plan_print() {
+  if (planned_program.data() == nullptr) {
+    printf("Motion Runner: nothing is planned\n");
+    return;
+  }
+  printf("Motion Runner: %i steps, %i paths, %.2f in of driving\n", (int)planned_poses.size(), (int)planned_paths.size(), planned_distance);
+  for (std::size_t i = 0; i < planned_poses.size(); i++)
+    printf("  %2i: op %2i  (%.2f, %.2f, %.2f)\n", (int)i, planned_program[i].op, planned_poses[i].x, planned_poses[i].y, planned_poses[i].theta);
+}
+
+void MotionRunner::step_run(const motion_step& step) {
+  switch (step.op) {
+    case OP_POSE_SET:
+      ez::odom_pose_set(*drive, {step.x, step.y, step.theta});
+      break;
+
+    case OP_DRIVE:
+      if (step.slew_set)
+        drive->pid_drive_set(step.x, step.speed, step.slew);
+      else
+        drive->pid_drive_set(step.x, step.speed);
+      break;
+
+    case OP_ODOM_DRIVE:
+      if (step.slew_set)
+        drive->pid_odom_set(step.x, step.speed, step.slew);
+      else
+        drive->pid_odom_set(step.x, step.speed);
+      break;
+
+    case OP_TURN:
+      if (step.behavior_set && step.slew_set)
+        drive->pid_turn_set(step.theta, step.speed, step.behavior, step.slew);
+      else if (step.behavior_set)
+        drive->pid_turn_set(step.theta, step.speed, step.behavior);
+      else if (step.slew_set)
+        drive->pid_turn_set(step.theta, step.speed, step.slew);
+      else
+        drive->pid_turn_set(step.theta, step.speed);
+      break;
+
+    case OP_TURN_TO_POINT: {
+      pose target = target_get(step);
+      target.theta = ANGLE_NOT_SET;
+      if (step.behavior_set && step.slew_set)
+        drive->pid_turn_set(target, step.dir, step.speed, step.behavior, step.slew);
+      else if (step.behavior_set)
+        drive->pid_turn_set(target, step.dir, step.speed, step.behavior);
+      else if (step.slew_set)
+        drive->pid_turn_set(target, step.dir, step.speed, step.slew);
+      else
+        drive->pid_turn_set(target, step.dir, step.speed);
+      break;
+    }
+
+    case OP_SWING:
+      if (step.behavior_set && step.slew_set)
+        drive->pid_swing_set(step.swing, step.theta, step.speed, step.arg, step.behavior, step.slew);
+      else if (step.behavior_set)
+        drive->pid_swing_set(step.swing, step.theta, step.speed, step.arg, step.behavior);
+      else if (step.slew_set)
+        drive->pid_swing_set(step.swing, step.theta, step.speed, step.arg, step.slew);
+      else
+        drive->pid_swing_set(step.swing, step.theta, step.speed, step.arg);
+      break;
+
+    case OP_ODOM_MOVE: {
+      odom movement = {target_get(step), step.dir, step.speed};
+      if (step.behavior_set) movement.turn_behavior = step.behavior;
+      if (step.slew_set)
+        drive->pid_odom_set(movement, step.slew);
+      else
+        drive->pid_odom_set(movement);
+      break;
+    }
+
+    case OP_WAIT:
+      drive->pid_wait();
+      break;
+
+    case OP_WAIT_CHAIN:
+      drive->pid_wait_quick_chain();
+      break;
+
+    case OP_WAIT_UNTIL:
+      drive->pid_wait_until(step.x);
+      break;
+
+    case OP_WAIT_INDEX:
+      drive->pid_wait_until_index(step.arg);
+      break;
+
+    case OP_DELAY:
+      pros::delay(step.arg);
+      break;
+
+    case OP_ACTUATOR:
+      actuators[step.id](step.arg, step.mirrored);
+      break;
+
+    case OP_TRIGGER: {
+      int start = pros::millis();
+      while (!stopping && !triggers[step.id]() && (step.arg == 0 || (int)pros::millis() - start < step.arg))
+        pros::delay(util::DELAY_TIME);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+// Parses the text after a builder name, returns false if the line is bad
+static bool token_to_dir(const char* token, drive_directions& output) {
+  if (strcmp(token, "fwd") == 0)
+    output = fwd;
+  else if (strcmp(token, "rev") == 0)
+    output = rev;
+  else
+    return false;
+  return true;
+}
+
+static bool token_to_behavior(const char* token, e_angle_behavior& output) {
+  if (strcmp(token, "raw") == 0)
+    output = raw;
+  else if (strcmp(token, "ccw") == 0)
+    output = ccw;
+  else if (strcmp(token, "cw") == 0)
+    output = cw;
+  else if (strcmp(token, "shortest") == 0)
+    output = shortest;
+  else if (strcmp(token, "longest") == 0)
+    output = longest;
+  else
+    return false;
+  return true;
+}
+
+static bool line_to_step(const char* line, motion_step& step) {
+  char name[24] = "", a[12] = "", b[12] = "";
+  double x = 0.0, y = 0.0, t = 0.0;
+  int speed = 0, value = 0;
+  if (sscanf(line, "%23s", name) != 1)
+    return false;
+  const char* params = line + strlen(name);
+
+  if (strcmp(name, "pose_set") == 0) {
+    if (sscanf(params, "%lf %lf %lf", &x, &y, &t) != 3) return false;
+    step = motion::pose_set(x, y, t);
+  } else if (strcmp(name, "drive") == 0 || strcmp(name, "odom_drive") == 0) {
+    int found = sscanf(params, "%lf %i %11s", &x, &speed, a);
+    if (found < 2) return false;
+    bool odom_drive = strcmp(name, "odom_drive") == 0;
+    if (found == 3)
+      step = odom_drive ? motion::odom_drive(x, speed, strcmp(a, "true") == 0) : motion::drive(x, speed, strcmp(a, "true") == 0);
+    else
+      step = odom_drive ? motion::odom_drive(x, speed) : motion::drive(x, speed);
+  } else if (strcmp(name, "turn") == 0) {
+    int found = sscanf(params, "%lf %i %11s", &t, &speed, a);
+    if (found < 2) return false;
+    e_angle_behavior behavior = shortest;
+    if (found == 3 && !token_to_behavior(a, behavior)) return false;
+    step = found == 3 ? motion::turn(t, speed, behavior) : motion::turn(t, speed);
+  } else if (strcmp(name, "turn_to_point") == 0 || strcmp(name, "odom_move") == 0 || strcmp(name, "path_point") == 0) {
+    drive_directions dir = fwd;
+    if (sscanf(params, "%lf %lf %11s %i", &x, &y, a, &speed) == 4 && token_to_dir(a, dir)) {
+      if (strcmp(name, "turn_to_point") == 0)
+        step = motion::turn_to_point(x, y, dir, speed);
+      else if (strcmp(name, "odom_move") == 0)
+        step = motion::odom_move(x, y, dir, speed);
+      else
+        step = motion::path_point(x, y, dir, speed);
+    } else if (strcmp(name, "odom_move") == 0 && sscanf(params, "%lf %lf %lf %11s %i", &x, &y, &t, a, &speed) == 5 && token_to_dir(a, dir)) {
+      step = motion::odom_move(x, y, t, dir, speed);
+    } else {
+      return false;
+    }
+  } else if (strcmp(name, "swing") == 0) {
+    if (sscanf(params, "%11s %lf %i %i", b, &t, &speed, &value) < 3) return false;
+    if (strcmp(b, "left") != 0 && strcmp(b, "right") != 0) return false;
+    step = motion::swing(strcmp(b, "left") == 0 ? LEFT_SWING : RIGHT_SWING, t, speed, value);
+  } else if (strcmp(name, "odom_path") == 0) {
+    int found = sscanf(params, "%i %11s", &value, a);
+    if (found < 1) return false;
+    step = motion::odom_path(value, found == 2 && strcmp(a, "true") == 0);
+  } else if (strcmp(name, "wait") == 0) {
+    step = motion::wait();
+  } else if (strcmp(name, "wait_chain") == 0) {
+    step = motion::wait_chain();
+  } else if (strcmp(name, "wait_until") == 0) {
+    if (sscanf(params, "%lf", &x) != 1) return false;
+    step = motion::wait_until(x);
+  } else if (strcmp(name, "wait_until_index") == 0) {
+    if (sscanf(params, "%i", &value) != 1) return false;
+    step = motion::wait_until_index(value);
+  } else if (strcmp(name, "delay") == 0) {
+    if (sscanf(params, "%i", &value) != 1) return false;
+    step = motion::delay(value);
+  } else if (strcmp(name, "actuator") == 0 || strcmp(name, "trigger") == 0) {
+    if (sscanf(params, "%i %i", &speed, &value) != 2) return false;
+    step = strcmp(name, "actuator") == 0 ? motion::actuator(speed, value) : motion::trigger(speed, value);
+  } else if (strcmp(name, "skip_if") == 0) {
+    if (sscanf(params, "%i %i", &speed, &value) != 2) return false;
+    step = motion::skip_if(speed, value);
+  } else if (strcmp(name, "end") == 0) {
+    step = motion::end();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool MotionRunner::sd_load(std::string path, std::vector<motion_step>& program) {
+  if (!util::SD_CARD_ACTIVE) {
+    printf("Motion Runner: no SD card, can't load %s!\n", path.c_str());
+    return false;
+  }
+
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == nullptr) {
+    printf("Motion Runner: couldn't open %s!\n", path.c_str());
+    return false;
+  }
+
+  program.clear();
+  char line[96];
+  int line_number = 0;
+  bool success = true;
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    line_number++;
+
+    // Skip blank lines and comments
+    const char* start = line + strspn(line, " \t");
+    if (*start == '\n' || *start == '\r' || *start == '\0' || *start == '#')
+      continue;
+
+    motion_step step;
+    if (!line_to_step(start, step)) {
+      printf("Motion Runner: couldn't parse line %i of %s!\n", line_number, path.c_str());
+      success = false;
+      break;
+    }
+    program.push_back(step);
+  }
+  fclose(file);
+  return success;
+}
@@ -0,0 +1,16 @@
+#include "motor_util.hpp"
+
+using namespace ez;
+
+double ez::motor_rpm_max(const pros::Motor& motor) {
+  switch (motor.get_gearing()) {
+    case pros::MotorGears::red:
+      return 100.0;
+    case pros::MotorGears::blue:
+      return 600.0;
+    default:
+      return 200.0;
+  }
+}
+
+double ez::drive_rpm_max(Drive& drive) { return motor_rpm_max(drive.left_motors.front()); }
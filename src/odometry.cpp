@@ -0,0 +1,290 @@
+#include "odometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ez;
+
+// The heading turns less than this in one tick, so a bigger change means someone set it
+static constexpr double JUMP_ANGLE = 20.0;
+// Every Odometry, so pose sets on a chassis can find the one tracking it
+static constexpr int MAX_ODOMETRY = 4;
+static std::array<Odometry*, MAX_ODOMETRY> instances = {};
+
+// Which way each tracker's offset moves it when the robot turns clockwise, left, right, front, back
+static constexpr double TURN_SIGNS[4] = {-1.0, 1.0, -1.0, 1.0};
+
+tick_counter::tick_counter(tracking_wheel* tracker) : tracker(tracker) {}
+
+void tick_counter::tracker_set(tracking_wheel* input) {
+  tracker = input;
+  reset();
+}
+
+tracking_wheel* tick_counter::tracker_get() { return tracker; }
+
+// Sensors report whole ticks, rounding only undoes the double get_raw() returns them as
+uint32_t tick_counter::raw_get() { return tracker == nullptr ? 0 : (uint32_t)llround(tracker->get_raw()); }
+
+int32_t tick_counter::delta_get() {
+  uint32_t raw = raw_get();
+  int32_t delta = tick_delta(raw, last);
+  last = raw;
+  total += delta;
+  return delta;
+}
+
+int64_t tick_counter::total_get() { return total; }
+
+double tick_counter::inches(int64_t ticks) {
+  if (tracker == nullptr || tracker->ticks_per_inch() == 0.0) return 0.0;
+  return ticks / tracker->ticks_per_inch();
+}
+
+void tick_counter::reset() {
+  last = raw_get();
+  total = 0;
+}
+
+Odometry::Odometry(Drive& drive) : drive(&drive) {
+  for (auto& instance : instances) {
+    if (instance != nullptr) continue;
+    instance = this;
+    return;
+  }
+  printf("Odometry: only %i can be made!\n", MAX_ODOMETRY);
+}
+
+Odometry* Odometry::find(Drive& input) {
+  for (auto instance : instances)
+    if (instance != nullptr && instance->drive == &input) return instance;
+  return nullptr;
+}
+
+void ez::odom_pose_set(Drive& drive, pose target) {
+  Odometry* odometry = Odometry::find(drive);
+  if (odometry != nullptr)
+    odometry->pose_set(target);
+  else if (target.theta == ANGLE_NOT_SET)
+    drive.odom_xy_set(target.x, target.y);
+  else
+    drive.odom_xyt_set(target.x, target.y, target.theta);
+}
+
+void Odometry::trackers_update() {
+  counters[0].tracker_set(drive->odom_tracker_left);
+  counters[1].tracker_set(drive->odom_tracker_right);
+  counters[2].tracker_set(drive->odom_tracker_front);
+  counters[3].tracker_set(drive->odom_tracker_back);
+  if (counters[0].tracker_get() == nullptr && counters[1].tracker_get() == nullptr)
+    printf("Odometry: no vertical tracker is set, only the chassis is tracking!\n");
+  started = false;
+}
+
+void Odometry::enable(bool enable) { is_enabled = enable; }
+
+bool Odometry::enabled() { return is_enabled; }
+
+double Odometry::sign_x() { return drive->odom_x_direction_get() ? -1.0 : 1.0; }
+
+double Odometry::sign_y() { return drive->odom_y_direction_get() ? -1.0 : 1.0; }
+
+// Clockwise positive, like the chassis defaults to
+double Odometry::theta_get() {
+  double theta = drive->odom_theta_get() * (drive->odom_theta_direction_get() ? -1.0 : 1.0);
+  return fusion == nullptr ? theta : theta + fusion->correction_get();
+}
+
+void Odometry::imu_fusion_set(ImuFusion& input) { fusion = &input; }
+
+void Odometry::adopt() {
+  x.reset(drive->odom_x_get() * sign_x());
+  y.reset(drive->odom_y_get() * sign_y());
+}
+
+void Odometry::gyro_enable(bool enable) { is_gyro_enabled = enable; }
+
+bool Odometry::gyro_enabled() { return is_gyro_enabled; }
+
+// Heading at this moment, the IMU's last sample is pushed forward by the gyro rate for however old it is
+double Odometry::heading_now(uint64_t now, double& rate) {
+  double read = theta_get();
+  double raw_rate = drive->imu.get_gyro_rate().z;
+
+  // The gyro's sign isn't tied to the chassis' heading, so it's learned from which way they move together
+  if (std::isfinite(raw_rate) && fabs(read - theta_read_last) < JUMP_ANGLE) gyro_correlation += raw_rate * (read - theta_read_last);
+  double sign = gyro_correlation >= 0.0 ? 1.0 : -1.0;
+  rate = std::isfinite(raw_rate) && is_gyro_enabled ? raw_rate * sign * drive->drive_imu_scaler_get() : NAN;
+
+  // The IMU doesn't sample in step with this tick, a new value was taken somewhere since the last tick
+  if (read != theta_read_last) sample_time = now - (now - time_last) / 2;
+  theta_read_last = read;
+
+  if (std::isnan(rate)) return read;
+  return read + rate * (now - sample_time) / 1000000.0;
+}
+
+void Odometry::iterate() {
+  std::array<int32_t, 4> ticks;
+  for (int i = 0; i < 4; i++)
+    ticks[i] = counters[i].delta_get();
+
+  uint64_t now = pros::micros();
+  double rate = 0.0;
+  double theta = heading_now(now, rate);
+  double dt = (now - time_last) / 1000000.0;
+  time_last = now;
+
+  bool has_vertical = counters[0].tracker_get() != nullptr || counters[1].tracker_get() != nullptr;
+  if (!is_enabled || !has_vertical || !drive->odom_enabled()) {
+    started = false;
+    return;
+  }
+
+  if (!started) {
+    // The chassis already has any pose set while this wasn't running
+    set_mutex.take();
+    set_pending = false;
+    set_mutex.give();
+    adopt();
+    theta_last = theta;
+    rate_last = rate;
+    started = true;
+    return;
+  }
+
+  // A pose set starts from there, this tick's motion happened before it
+  set_mutex.take();
+  bool was_set = set_pending;
+  if (set_pending) {
+    x.reset(set_x * sign_x());
+    y.reset(set_y * sign_y());
+    set_pending = false;
+    // Everything before the set was somewhere else
+    history_count = 0;
+    correction_x = correction_y = 0.0;
+  }
+  set_mutex.give();
+  if (was_set) {
+    theta_last = theta;
+    rate_last = rate;
+    return;
+  }
+
+  double delta_theta = theta - theta_last;
+  if (fabs(delta_theta) > JUMP_ANGLE) {
+    delta_theta = 0.0;
+    theta_last = theta;
+  }
+  double turn = util::to_rad(delta_theta);
+
+  // Take the turn out of each tracker so what's left is how far the center moved
+  double vertical = 0.0, horizontal = 0.0;
+  int vertical_count = 0, horizontal_count = 0;
+  for (int i = 0; i < 4; i++) {
+    tracking_wheel* tracker = counters[i].tracker_get();
+    if (tracker == nullptr) continue;
+    double center = counters[i].inches(ticks[i]) + TURN_SIGNS[i] * tracker->distance_to_center_get() * turn;
+    if (i < 2) {
+      vertical += center;
+      vertical_count++;
+    } else {
+      horizontal += center;
+      horizontal_count++;
+    }
+  }
+  vertical /= vertical_count;
+  if (horizontal_count > 0) horizontal /= horizontal_count;
+
+  // Heading through the tick is a cubic through both ends and their gyro rates, without rates it's a constant turn.
+  // Simpson's rule over that rotates the tick's motion into the field
+  double middle = (theta_last + theta) / 2.0;
+  if (!std::isnan(rate) && !std::isnan(rate_last))
+    middle += dt * (rate_last - rate) / 8.0;
+  double headings[3] = {util::to_rad(theta_last), util::to_rad(middle), util::to_rad(theta)};
+  double sin_sum = (sin(headings[0]) + 4.0 * sin(headings[1]) + sin(headings[2])) / 6.0;
+  double cos_sum = (cos(headings[0]) + 4.0 * cos(headings[1]) + cos(headings[2])) / 6.0;
+  x.add(vertical * sin_sum + horizontal * cos_sum);
+  y.add(vertical * cos_sum - horizontal * sin_sum);
+  theta_last = theta;
+  rate_last = rate;
+
+  // Corrections move the history too, so pose_at() doesn't hand back a position from before them
+  set_mutex.take();
+  if (correction_x != 0.0 || correction_y != 0.0) {
+    x.add(correction_x * sign_x());
+    y.add(correction_y * sign_y());
+    for (auto& entry : history) {
+      entry.position.x += correction_x;
+      entry.position.y += correction_y;
+    }
+    correction_x = correction_y = 0.0;
+  }
+
+  history[history_count++ % HISTORY_SIZE] = {pros::millis(), pose_get()};
+  set_mutex.give();
+}
+
+pose Odometry::pose_get() { return {x.sum * sign_x(), y.sum * sign_y(), drive->odom_theta_get()}; }
+
+void Odometry::xy_set(double input_x, double input_y) { pose_set({input_x, input_y, ANGLE_NOT_SET}); }
+
+void Odometry::pose_set(pose target) {
+  if (target.theta == ANGLE_NOT_SET)
+    drive->odom_xy_set(target.x, target.y);
+  else
+    drive->odom_xyt_set(target.x, target.y, target.theta);
+
+  // iterate() may be adding to the old position right now, so it takes the new one on its next tick
+  set_mutex.take();
+  set_x = target.x;
+  set_y = target.y;
+  set_pending = true;
+  set_mutex.give();
+}
+
+void Odometry::correct(double input_x, double input_y) {
+  // One write when it happens, like a pose set, the chassis' task keeps its own ticks
+  drive->odom_xy_set(drive->odom_x_get() + input_x, drive->odom_y_get() + input_y);
+  set_mutex.take();
+  correction_x += input_x;
+  correction_y += input_y;
+  set_mutex.give();
+}
+
+bool Odometry::pose_at(uint32_t time, pose& output) {
+  set_mutex.take();
+  bool found = history_find(time, output);
+  // Corrections that haven't reached the history yet count too, so two in a row don't both make the same move
+  if (found) {
+    output.x += correction_x;
+    output.y += correction_y;
+  }
+  set_mutex.give();
+  return found;
+}
+
+bool Odometry::history_find(uint32_t time, pose& output) {
+  int oldest = std::max(history_count - HISTORY_SIZE, 0);
+  for (int i = history_count - 1; i > oldest; i--) {
+    const history_entry& after = history[i % HISTORY_SIZE];
+    const history_entry& before = history[(i - 1) % HISTORY_SIZE];
+    if (before.time > time) continue;
+    if (after.time < time) return false;
+    double t = after.time == before.time ? 1.0 : (double)(time - before.time) / (after.time - before.time);
+    output = {before.position.x + (after.position.x - before.position.x) * t,
+              before.position.y + (after.position.y - before.position.y) * t,
+              before.position.theta + (after.position.theta - before.position.theta) * t};
+    return true;
+  }
+  return false;
+}
+
+void Odometry::print() {
+  static const char* NAMES[] = {"left", "right", "front", "back"};
+  printf("Odometry: x %.3f  y %.3f  a %.2f\n", x.sum * sign_x(), y.sum * sign_y(), drive->odom_theta_get());
+  for (int i = 0; i < 4; i++) {
+    if (counters[i].tracker_get() == nullptr) continue;
+    printf("  %-5s %10lld ticks  %9.3f in\n", NAMES[i], (long long)counters[i].total_get(), counters[i].inches(counters[i].total_get()));
+  }
+}
@@ -0,0 +1,134 @@
+#include "output_stage.hpp"
+
+using namespace ez;
+
+OutputStage::OutputStage() { port_to_channel.fill(-1); }
+
+int OutputStage::channel_add(pros::Motor& motor) {
+  int port = abs(motor.get_port());
+  if (port < 1 || port > 21) {
+    printf("Output Stage: port %i is not a smart port!\n", port);
+    return -1;
+  }
+  if (port_to_channel[port] != -1)
+    return port_to_channel[port];
+  if (motor_count >= MAX_MOTORS) {
+    printf("Output Stage: only %i motors fit, port %i wasn't added!\n", MAX_MOTORS, port);
+    return -1;
+  }
+  motors[motor_count] = {&motor, 0, NOT_SENT};
+  port_to_channel[port] = motor_count;
+  return motor_count++;
+}
+
+void OutputStage::drive_add(Drive& input) {
+  drive = &input;
+  for (auto& motor : drive->left_motors) {
+    int channel = channel_add(motor);
+    if (channel != -1) left_mask |= 1 << channel;
+  }
+  for (auto& motor : drive->right_motors) {
+    int channel = channel_add(motor);
+    if (channel != -1) right_mask |= 1 << channel;
+  }
+  pto_update();
+}
+
+void OutputStage::motor_add(pros::Motor& motor) { channel_add(motor); }
+
+void OutputStage::piston_add(pros::adi::DigitalOut& piston) {
+  if (piston_count >= MAX_PISTONS) {
+    printf("Output Stage: only %i pistons fit!\n", MAX_PISTONS);
+    return;
+  }
+  pistons[piston_count++] = {&piston, -1, -1};
+}
+
+void OutputStage::pto_update() {
+  if (drive == nullptr) return;
+  uint32_t ports = 0;
+  for (int port : drive->pto_active)
+    ports |= 1u << abs(port);
+  pto_ports_set(ports);
+}
+
+void OutputStage::pto_ports_set(uint32_t ports) {
+  uint32_t mask = 0;
+  for (int port = 1; port <= 21; port++)
+    if ((ports & (1u << port)) && port_to_channel[port] != -1)
+      mask |= 1 << port_to_channel[port];
+
+  // The PTO stopped switched motors on its own, so whatever was sent to them before is stale
+  for (int i = 0; i < motor_count; i++) {
+    if (!((mask ^ pto_mask) & (1 << i))) continue;
+    motors[i].command = 0;
+    motors[i].sent = NOT_SENT;
+  }
+  pto_mask = mask;
+  if (drive != nullptr)
+    pto_size = drive->pto_active.size();
+}
+
+void OutputStage::drive_set(int left, int right) {
+  if (drive->opcontrol_drive_reverse_get()) {
+    int temp = left;
+    left = -right;
+    right = -temp;
+  }
+  left = util::clamp(left, 127, -127);
+  right = util::clamp(right, 127, -127);
+
+  uint32_t active = (left_mask | right_mask) & ~pto_mask;
+  for (int i = 0; i < motor_count; i++) {
+    if (!(active & (1 << i))) continue;
+    motors[i].command = left_mask & (1 << i) ? left : right;
+  }
+}
+
+void OutputStage::motor_set(pros::Motor& motor, int voltage) {
+  int channel = port_to_channel[abs(motor.get_port())];
+  if (channel == -1) {
+    printf("Output Stage: port %i wasn't added!\n", abs(motor.get_port()));
+    return;
+  }
+  motors[channel].command = util::clamp(voltage, 127, -127);
+}
+
+void OutputStage::piston_set(pros::adi::DigitalOut& piston, bool state) {
+  for (int i = 0; i < piston_count; i++) {
+    if (pistons[i].piston == &piston) {
+      pistons[i].command = state;
+      return;
+    }
+  }
+  printf("Output Stage: piston wasn't added!\n");
+}
+
+void OutputStage::flush() {
+  if (drive != nullptr && drive->pto_active.size() != pto_size)
+    pto_update();
+
+  for (int i = 0; i < motor_count; i++) {
+    motor_channel& channel = motors[i];
+    // Motors in a PTO are run by the PTO manager
+    if ((pto_mask & (1 << i)) || channel.command == channel.sent) continue;
+    channel.motor->move(channel.command);
+    channel.sent = channel.command;
+  }
+  for (int i = 0; i < piston_count; i++) {
+    piston_channel& channel = pistons[i];
+    if (channel.command == -1 || channel.command == channel.sent) continue;
+    channel.piston->set_value(channel.command);
+    channel.sent = channel.command;
+  }
+}
+
+void OutputStage::invalidate() {
+  for (int i = 0; i < motor_count; i++)
+    motors[i].sent = NOT_SENT;
+  // Pistons are only set when they toggle, so old commands would undo what something else did
+  for (int i = 0; i < piston_count; i++) {
+    pistons[i].command = -1;
+    pistons[i].sent = -1;
+  }
+}
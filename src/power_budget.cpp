@@ -0,0 +1,161 @@
+#include "power_budget.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ez;
+
+// Share of the budget each group gets for each priority, {drive, intake, arm}
+static constexpr double PRIORITY_WEIGHTS[4][3] = {
+    {1.0, 1.0, 1.0},  // Balanced
+    {3.0, 1.0, 1.0},  // Drive
+    {1.0, 3.0, 1.0},  // Intake
+    {1.0, 1.0, 3.0},  // Arm
+};
+static constexpr int MOTOR_MAX_LIMIT = 2500;
+static constexpr int MOTOR_MIN_LIMIT = 300;
+// Motors get what they're drawing plus this much to speed up, so idle motors don't hold current others need
+static constexpr int DEMAND_HEADROOM = 1250;
+
+PowerBudget::PowerBudget(Drive& drive, PtoManager& pto) : drive(&drive), pto(&pto) {}
+
+void PowerBudget::drive_add() {
+  for (auto& motor : drive->left_motors)
+    motor_add(motor, GROUP_DRIVE);
+  for (auto& motor : drive->right_motors)
+    motor_add(motor, GROUP_DRIVE);
+}
+
+void PowerBudget::motor_add(pros::Motor& motor, budget_group group) {
+  if (motor_count >= MAX_MOTORS) {
+    printf("Power Budget: only %i motors fit, port %i wasn't added!\n", MAX_MOTORS, abs(motor.get_port()));
+    return;
+  }
+  motors[motor_count++] = {&motor, group, MOTOR_MAX_LIMIT, 0, 0.0, 0.0, -1.0, false};
+}
+
+void PowerBudget::total_set(int mA) { total = mA; }
+
+void PowerBudget::priority_set(budget_priority input) { priority = input; }
+
+budget_priority PowerBudget::priority_get() { return priority; }
+
+void PowerBudget::thermal_horizon_set(double seconds) { horizon = seconds; }
+
+void PowerBudget::iterate() {
+  // PTO role changes set limits behind the budget's back, so every limit gets sent again
+  if (pto->ports_get() != pto_ports) {
+    pto_ports = pto->ports_get();
+    for (int i = 0; i < motor_count; i++)
+      motors[i].limit = -1;
+  }
+
+  uint32_t now = pros::millis();
+  double dt = last_time == 0 ? 0.0 : (now - last_time) / 1000.0;
+  last_time = now;
+
+  std::array<double, MAX_MOTORS> weights;
+  std::array<double, MAX_MOTORS> caps;
+  double weight_total = 0.0;
+  // Motors left on the drive share the whole drive's weight, so lending motors out doesn't shrink the drive's current
+  double drive_fraction = pto->drive_torque_fraction();
+  for (int i = 0; i < motor_count; i++) {
+    budget_motor& current = motors[i];
+    double temperature = current.motor->get_temperature();
+    current.current = current.motor->get_current_draw();
+
+    // Temperature only changes a degree at a time, so the slope is smoothed over a few seconds
+    if (std::isfinite(temperature)) {
+      if (dt > 0.0 && current.temperature != 0.0)
+        current.slope += ((temperature - current.temperature) / dt - current.slope) * fmin(dt / 5.0, 1.0);
+      current.temperature = temperature;
+    }
+    current.time_to_throttle = current.slope > 0.001 ? fmax(THROTTLE_TEMP - current.temperature, 0.0) / current.slope : -1.0;
+
+    // Motors heading for throttling get less current so they heat up slower
+    double derate = 1.0;
+    if (current.temperature >= THROTTLE_TEMP)
+      derate = 0.25;
+    else if (current.time_to_throttle >= 0.0 && current.time_to_throttle < horizon)
+      derate = util::clamp(current.time_to_throttle / horizon, 1.0, 0.25);
+    if (derate < 1.0 && !current.warned) {
+      printf("Power Budget: port %i is predicted to throttle in %.0fs at %.0fC\n", abs(current.motor->get_port()), current.time_to_throttle, current.temperature);
+      current.warned = true;
+    } else if (derate == 1.0) {
+      current.warned = false;
+    }
+
+    // Drive motors lent to a mechanism are budgeted with the arm, capped at the PTO group's mechanism current
+    int mechanism_current = current.group == GROUP_DRIVE ? pto->mechanism_current_get(current.motor->get_port()) : -1;
+    budget_group group = mechanism_current >= 0 ? GROUP_ARM : current.group;
+    weights[i] = PRIORITY_WEIGHTS[priority][group];
+    if (group == GROUP_DRIVE && drive_fraction > 0.0) weights[i] /= drive_fraction;
+    caps[i] = (mechanism_current >= 0 ? std::min(mechanism_current, MOTOR_MAX_LIMIT) : MOTOR_MAX_LIMIT) * derate;
+    caps[i] = fmin(caps[i], current.current + DEMAND_HEADROOM);
+    weight_total += weights[i];
+  }
+
+  // Split the budget by weight, then hand what capped motors couldn't use to the rest
+  std::array<double, MAX_MOTORS> limits = {};
+  std::array<bool, MAX_MOTORS> capped = {};
+  double remaining = total;
+  for (int pass = 0; pass < 4 && remaining > 1.0 && weight_total > 0.0; pass++) {
+    double share = remaining / weight_total;
+    remaining = 0.0;
+    double next_weight_total = 0.0;
+    for (int i = 0; i < motor_count; i++) {
+      if (capped[i]) continue;
+      limits[i] += share * weights[i];
+      if (limits[i] >= caps[i]) {
+        remaining += limits[i] - caps[i];
+        limits[i] = caps[i];
+        capped[i] = true;
+      } else {
+        next_weight_total += weights[i];
+      }
+    }
+    weight_total = next_weight_total;
+  }
+
+  // Only send limits that changed enough to matter
+  for (int i = 0; i < motor_count; i++) {
+    int limit = util::clamp(limits[i], MOTOR_MAX_LIMIT, MOTOR_MIN_LIMIT);
+    if (abs(limit - motors[i].limit) < 50) continue;
+    motors[i].motor->set_current_limit(limit);
+    motors[i].limit = limit;
+  }
+}
+
+PowerBudget::budget_motor* PowerBudget::motor_find(int port) {
+  for (int i = 0; i < motor_count; i++)
+    if (abs(motors[i].motor->get_port()) == abs(port)) return &motors[i];
+  return nullptr;
+}
+
+int PowerBudget::limit_get(int port) {
+  budget_motor* found = motor_find(port);
+  return found == nullptr ? -1 : found->limit;
+}
+
+double PowerBudget::time_to_throttle_get(int port) {
+  budget_motor* found = motor_find(port);
+  return found == nullptr ? -1.0 : found->time_to_throttle;
+}
+
+bool PowerBudget::throttle_predicted() {
+  for (int i = 0; i < motor_count; i++)
+    if (motors[i].temperature >= THROTTLE_TEMP || (motors[i].time_to_throttle >= 0.0 && motors[i].time_to_throttle < horizon)) return true;
+  return false;
+}
+
+void PowerBudget::print() {
+  static const char* GROUP_NAMES[] = {"drive", "intake", "arm"};
+  printf("Power budget: %i mA, priority %i\n", total, priority);
+  for (int i = 0; i < motor_count; i++) {
+    const budget_motor& current = motors[i];
+    printf("  port %2i %-6s  %4.0fC  %+5.2fC/s  %4i mA of %4i mA", abs(current.motor->get_port()), GROUP_NAMES[current.group], current.temperature, current.slope, current.current, current.limit);
+    if (current.time_to_throttle >= 0.0)
+      printf("  throttles in %.0fs", current.time_to_throttle);
+    printf("\n");
+  }
+}
@@ -0,0 +1,121 @@
+#include "pto.hpp"
+
+#include <bit>
+
+using namespace ez;
+
+PtoManager::PtoManager(Drive& drive) : drive(&drive) {}
+
+pros::Motor* PtoManager::drive_motor_find(int port) {
+  for (auto& motor : drive->left_motors)
+    if (abs(motor.get_port()) == abs(port)) return &motor;
+  for (auto& motor : drive->right_motors)
+    if (abs(motor.get_port()) == abs(port)) return &motor;
+  return nullptr;
+}
+
+int PtoManager::group_add(std::initializer_list<int> input, pros::adi::DigitalOut& piston, int mechanism_current, pros::motor_brake_mode_e_t mechanism_brake) {
+  if (group_count >= MAX_GROUPS) {
+    printf("PTO: only %i groups fit!\n", MAX_GROUPS);
+    return -1;
+  }
+  if ((int)input.size() > MAX_GROUP_MOTORS) {
+    printf("PTO: only %i motors fit in a group!\n", MAX_GROUP_MOTORS);
+    return -1;
+  }
+
+  // Every drive motor fits without pto_active growing when roles switch
+  drive->pto_active.reserve(drive->left_motors.size() + drive->right_motors.size());
+
+  group& output = groups[group_count];
+  output.motor_count = 0;
+  for (int port : input) {
+    pros::Motor* motor = drive_motor_find(port);
+    if (motor == nullptr) {
+      printf("PTO: port %i is not a drive motor!\n", abs(port));
+      return -1;
+    }
+    if (motor == &drive->left_motors.front() || motor == &drive->right_motors.front()) {
+      printf("PTO: port %i is the first motor on its side, the chassis needs it for autonomous!\n", abs(port));
+      return -1;
+    }
+    for (int i = 0; i < group_count; i++) {
+      for (int j = 0; j < groups[i].motor_count; j++) {
+        if (groups[i].motors[j] == motor) {
+          printf("PTO: port %i is already in group %i!\n", abs(port), i);
+          return -1;
+        }
+      }
+    }
+    output.motors[output.motor_count++] = motor;
+  }
+  output.piston = &piston;
+  output.mechanism_current = mechanism_current;
+  output.mechanism_brake = mechanism_brake;
+  output.role = PTO_DRIVE;
+  return group_count++;
+}
+
+void PtoManager::role_set(int id, pto_role role) {
+  if (id < 0 || id >= group_count) {
+    printf("PTO: group %i doesn't exist!\n", id);
+    return;
+  }
+  group& current = groups[id];
+  if (current.role == role) return;
+
+  for (int i = 0; i < current.motor_count; i++) {
+    pros::Motor* motor = current.motors[i];
+    int port = motor->get_port();
+
+    // Stop the motor so the old role's command doesn't carry over
+    motor->move(0);
+    if (role == PTO_MECHANISM) {
+      ports |= 1u << abs(port);
+      drive->pto_active.push_back(port);
+      motor->set_current_limit(current.mechanism_current);
+      motor->set_brake_mode(current.mechanism_brake);
+    } else {
+      ports &= ~(1u << abs(port));
+      std::erase(drive->pto_active, port);
+      motor->set_current_limit(drive->CURRENT_MA);
+      motor->set_brake_mode(drive->CURRENT_BRAKE);
+    }
+  }
+  current.piston->set_value(role == PTO_MECHANISM);
+  current.role = role;
+
+  if (outputs != nullptr)
+    outputs->pto_ports_set(ports);
+}
+
+pto_role PtoManager::role_get(int id) {
+  if (id < 0 || id >= group_count) return PTO_DRIVE;
+  return groups[id].role;
+}
+
+void PtoManager::group_move(int id, int voltage) {
+  if (id < 0 || id >= group_count || groups[id].role != PTO_MECHANISM) return;
+  for (int i = 0; i < groups[id].motor_count; i++)
+    groups[id].motors[i]->move(voltage);
+}
+
+int PtoManager::drive_motors_active() { return drive->left_motors.size() + drive->right_motors.size() - std::popcount(ports); }
+
+double PtoManager::drive_torque_fraction() {
+  int total = drive->left_motors.size() + drive->right_motors.size();
+  return total == 0 ? 0.0 : drive_motors_active() / (double)total;
+}
+
+int PtoManager::mechanism_current_get(int port) {
+  if (!pto_check(port)) return -1;
+  for (int i = 0; i < group_count; i++)
+    for (int j = 0; j < groups[i].motor_count; j++)
+      if (abs(groups[i].motors[j]->get_port()) == abs(port)) return groups[i].mechanism_current;
+  return -1;
+}
+
+void PtoManager::outputs_set(OutputStage& input) {
+  outputs = &input;
+  outputs->pto_ports_set(ports);
+}
@@ -0,0 +1,52 @@
+#include "screen_text.hpp"
+
+#include <cstring>
+
+#include "liblvgl/llemu.h"
+
+using namespace ez;
+
+ScreenText::ScreenText(int period) : period(period) {
+  written.fill(false);
+  stale.fill(false);
+}
+
+void ScreenText::period_set(int ms) { period = ms; }
+
+bool ScreenText::due() { return pros::millis() - last_flush >= (uint32_t)period; }
+
+void ScreenText::print(int line, const char* format, ...) {
+  if (line < 0 || line >= LINES) {
+    printf("Screen Text: line %i is out of range!\n", line);
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  next[line].vprint(format, args);
+  va_end(args);
+  written[line] = true;
+}
+
+void ScreenText::clear(int line) {
+  if (line < 0 || line >= LINES) return;
+  next[line].clear();
+  written[line] = true;
+}
+
+int ScreenText::flush() {
+  if (!due()) return 0;
+  last_flush = pros::millis();
+
+  // Lines nobody wrote are left alone, so this doesn't fight other code that writes to the screen
+  int count = 0;
+  for (int i = 0; i < LINES; i++) {
+    if (!written[i] || (!stale[i] && strcmp(next[i].c_str(), sent[i].c_str()) == 0)) continue;
+    pros::c::lcd_set_text(i, next[i].c_str());
+    sent[i] = next[i];
+    stale[i] = false;
+    count++;
+  }
+  return count;
+}
+
+void ScreenText::invalidate() { stale.fill(true); }
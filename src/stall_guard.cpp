@@ -0,0 +1,165 @@
+#include "stall_guard.hpp"
+
+#include "motor_util.hpp"
+
+using namespace ez;
+
+// Running forward again spins up through a stall, so checks wait this long first
+static constexpr int RETRY_GRACE = 100;
+static constexpr int RETRY_TIME = 300;
+static constexpr int STALL_MIN_VOLTAGE = 6000;
+
+StallGuard::StallGuard(pros::Motor& motor) : motor(&motor) {}
+
+void StallGuard::stall_set(int current, double velocity, int time) {
+  stall_current = current;
+  stall_velocity = velocity;
+  stall_time = time;
+}
+
+void StallGuard::unjam_set(int speed, int input_reverse_time, int input_retries, int input_cooldown) {
+  reverse_speed = abs(speed);
+  reverse_time = input_reverse_time;
+  retries = input_retries;
+  cooldown = input_cooldown;
+}
+
+void StallGuard::unjam_enable(bool enable) { unjam_enabled = enable; }
+
+void StallGuard::command_set(int voltage) {
+  command = util::clamp(voltage, 127, -127);
+  command_brake = false;
+  has_command = true;
+}
+
+void StallGuard::move(int voltage) {
+  command_set(voltage);
+  if (!unjamming()) motor->move(command);
+}
+
+void StallGuard::brake() {
+  command_brake = true;
+  has_command = true;
+  if (!unjamming()) motor->brake();
+}
+
+// Goes back to the newest command, or what the motor was doing when it jammed if nothing was commanded through the guard
+void StallGuard::restore() {
+  if (!has_command)
+    motor->move_voltage(saved_voltage);
+  else if (command_brake)
+    motor->brake();
+  else
+    motor->move(command);
+}
+
+bool StallGuard::stalled() {
+  // Only look for stalls when the motor is being pushed hard
+  if (abs(motor->get_voltage()) < STALL_MIN_VOLTAGE)
+    return false;
+  return fabs(motor->get_actual_velocity()) < stall_velocity * motor_rpm_max(*motor) &&
+         motor->get_current_draw() >= stall_current && motor->get_efficiency() < 20.0;
+}
+
+void StallGuard::iterate() {
+  switch (state) {
+    case STALL_WATCHING: {
+      if (!stalled()) {
+        stall_timer = 0;
+        return;
+      }
+      // Count a stall once, then wait for it to clear
+      if (stall_timer >= stall_time) return;
+      stall_timer += util::DELAY_TIME;
+      if (stall_timer < stall_time) return;
+
+      log[stalls % LOG_SIZE] = {pros::millis(), (int16_t)motor->get_current_draw(), (int16_t)motor->get_actual_velocity(), 0, false};
+      stalls++;
+      printf("Stall Guard: port %i stalled at %i mA\n", abs(motor->get_port()), motor->get_current_draw());
+      if (!unjam_enabled) return;
+
+      saved_voltage = motor->get_voltage();
+      attempts = 0;
+      reverse();
+      break;
+    }
+
+    case STALL_REVERSING:
+      state_timer -= util::DELAY_TIME;
+      if (state_timer > 0) return;
+      restore();
+      state = STALL_RETRYING;
+      state_timer = RETRY_TIME;
+      stall_timer = 0;
+      break;
+
+    case STALL_RETRYING:
+      state_timer -= util::DELAY_TIME;
+      if (RETRY_TIME - state_timer > RETRY_GRACE && stalled())
+        stall_timer += util::DELAY_TIME;
+      else
+        stall_timer = 0;
+
+      if (stall_timer >= stall_time) {
+        if (attempts >= retries)
+          finish(false);
+        else
+          reverse();
+      } else if (state_timer <= 0) {
+        finish(true);
+      }
+      break;
+
+    case STALL_FAILED:
+      state_timer -= util::DELAY_TIME;
+      if (state_timer > 0) return;
+      state = STALL_WATCHING;
+      restore();
+      stall_timer = 0;
+      break;
+  }
+}
+
+void StallGuard::reverse() {
+  attempts++;
+  log[(stalls - 1) % LOG_SIZE].attempts = attempts;
+  motor->move(-util::sgn(saved_voltage) * reverse_speed);
+  state = STALL_REVERSING;
+  state_timer = reverse_time;
+}
+
+void StallGuard::finish(bool cleared) {
+  log[(stalls - 1) % LOG_SIZE].cleared = cleared;
+  printf("Stall Guard: port %i %s after %i tries\n", abs(motor->get_port()), cleared ? "cleared" : "is still jammed", attempts);
+  stall_timer = 0;
+  if (cleared) {
+    state = STALL_WATCHING;
+    restore();  // The command may have changed while retrying
+    return;
+  }
+  failures++;
+  motor->brake();
+  state = STALL_FAILED;
+  state_timer = cooldown;
+}
+
+bool StallGuard::unjamming() { return state != STALL_WATCHING; }
+
+stall_state StallGuard::state_get() { return state; }
+
+int StallGuard::stalls_get() { return stalls; }
+
+int StallGuard::failures_get() { return failures; }
+
+stall_event StallGuard::event_get(int index) {
+  if (index < 0 || index >= LOG_SIZE || index >= stalls) return {};
+  return log[(stalls - 1 - index) % LOG_SIZE];
+}
+
+void StallGuard::print() {
+  printf("Stall guard on port %i: %i stalls, %i not cleared\n", abs(motor->get_port()), stalls, failures);
+  for (int i = 0; i < std::min(stalls, LOG_SIZE); i++) {
+    stall_event event = event_get(i);
+    printf("  %6lu ms  %5i mA  %4i rpm  %i tries  %s\n", (unsigned long)event.time, event.current, event.velocity, event.attempts, event.cleared ? "cleared" : "jammed");
+  }
+}
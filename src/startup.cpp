@@ -0,0 +1,161 @@
+#include "startup.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace ez {
+namespace startup {
+
+/////
+//
+// Timing
+//
+/////
+
+struct phase {
+  const char* name;
+  uint32_t time;
+};
+static constexpr int MAX_PHASES = 16;
+static phase phases[MAX_PHASES];
+// Each mark takes its own slot, so initialize and the IMU task can mark at the same time
+static std::atomic<int> phase_count = 0;
+// initialize, and the IMU task if it was started, both have to finish before printing
+static std::atomic<int> print_waiting = 1;
+
+void mark(const char* name) {
+  int slot = phase_count.fetch_add(1);
+  if (slot >= MAX_PHASES) return;
+  phases[slot] = {name, pros::millis()};
+}
+
+static void phases_print() {
+  int count = std::min(phase_count.load(), MAX_PHASES);
+  // Marks from different tasks can take slots out of order
+  std::sort(phases, phases + count, [](const phase& a, const phase& b) { return a.time < b.time; });
+  uint32_t last = 0;
+  printf("Startup timing:\n");
+  for (int i = 0; i < count; i++) {
+    printf("  %-24s %5lu ms  (+%lu ms)\n", phases[i].name, (unsigned long)phases[i].time, (unsigned long)(phases[i].time - last));
+    last = phases[i].time;
+  }
+}
+
+void print() {
+  if (--print_waiting == 0) phases_print();
+}
+
+/////
+//
+// IMU
+//
+/////
+
+static Drive* imu_drive = nullptr;
+static ImuFusion* imu_fusion = nullptr;
+static std::atomic<bool> imu_finished = false;
+
+void imu_calibrate_async(Drive& drive, ImuFusion* fusion) {
+  imu_drive = &drive;
+  imu_fusion = fusion;
+  imu_finished = false;
+  print_waiting++;
+  pros::Task calibrate([]() {
+    // Extra IMUs calibrate alongside the chassis' IMU instead of after it
+    if (imu_fusion != nullptr) imu_fusion->calibrate_start();
+    // The selector is on the screen while this runs, so skip the loading animation
+    bool calibrated = imu_drive->drive_imu_calibrate(false);
+    // One IMU has nothing to fuse, so it skips the still-robot bias sample
+    if (imu_fusion != nullptr && imu_fusion->imu_count() > 1) calibrated = imu_fusion->calibrate_finish() && calibrated;
+    mark("imu calibrated");
+    imu_finished = true;
+    master.rumble(calibrated ? "." : "---");
+    if (--print_waiting == 0) phases_print();
+  });
+}
+
+bool imu_done() { return imu_finished; }
+
+bool imu_wait(int timeout) {
+  int start = pros::millis();
+  while (!imu_finished && (int)pros::millis() - start < timeout)
+    pros::delay(util::DELAY_TIME);
+  return imu_finished;
+}
+
+/////
+//
+// Auton selection
+//
+/////
+
+// Small binary record of the selected auton
+struct selection_record {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t page;
+  uint32_t autons_hash;
+  uint32_t checksum;
+};
+static constexpr uint32_t SELECTION_MAGIC = 0x45415553;  // "EAUS"
+static constexpr uint16_t SELECTION_VERSION = 1;
+static const char* SELECTION_PATH = "/usd/ez_auton.bin";
+static int saved_page = -1;
+static bool selection_loaded = false;  // Nothing is saved until the old record has been read
+
+// FNV-1a over every auton name, this changes if autons are added, removed or reordered
+static uint32_t autons_hash(AutonSelector& selector) {
+  uint32_t hash = 2166136261u;
+  for (auto& auton : selector.Autons) {
+    for (char c : auton.Name) {
+      hash ^= (uint8_t)c;
+      hash *= 16777619u;
+    }
+    hash ^= 0xFF;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t record_checksum(const selection_record& record) {
+  return record.magic ^ ((uint32_t)record.version << 16 | record.page) ^ record.autons_hash ^ 0xA5A5A5A5u;
+}
+
+bool selection_load(AutonSelector& selector) {
+  selection_loaded = true;
+  if (!util::SD_CARD_ACTIVE) return false;
+
+  FILE* file = fopen(SELECTION_PATH, "rb");
+  if (file == nullptr) return false;
+  selection_record record;
+  bool read = fread(&record, sizeof(record), 1, file) == 1;
+  fclose(file);
+
+  if (!read || record.magic != SELECTION_MAGIC || record.version != SELECTION_VERSION || record.checksum != record_checksum(record))
+    return false;
+  if (record.autons_hash != autons_hash(selector) || record.page >= selector.Autons.size())
+    return false;
+
+  selector.auton_page_current = record.page;
+  saved_page = record.page;
+  if (as::enabled())
+    selector.selected_auton_print();
+  return true;
+}
+
+void selection_update(AutonSelector& selector) {
+  int page = selector.auton_page_current;
+  if (!selection_loaded || page == saved_page || page < 0 || page >= (int)selector.Autons.size() || !util::SD_CARD_ACTIVE)
+    return;
+
+  selection_record record = {SELECTION_MAGIC, SELECTION_VERSION, (uint16_t)page, autons_hash(selector), 0};
+  record.checksum = record_checksum(record);
+  FILE* file = fopen(SELECTION_PATH, "wb");
+  if (file == nullptr) return;
+  fwrite(&record, sizeof(record), 1, file);
+  fclose(file);
+  saved_page = page;
+}
+
+}  // namespace startup
+}  // namespace ez
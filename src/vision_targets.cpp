@@ -0,0 +1,154 @@
+#include "vision_targets.hpp"
+
+#include <cmath>
+
+using namespace ez;
+
+static constexpr int MAX_BLOBS = 8;
+// Frames are about this old when they're read
+static constexpr int FRAME_LATENCY = 20;
+// Tracks this close and in view should show up, so missing them counts against them
+static constexpr double VISIBLE_RANGE = 48.0;
+static constexpr double CONFIDENCE_HIT = 0.25;
+static constexpr double CONFIDENCE_MISS = 0.15;
+
+VisionTargets::VisionTargets(int port, Odometry& odometry) : sensor(port), odometry(&odometry) { fov_set(61.0); }
+
+void VisionTargets::camera_set(double x, double y, double angle) { camera = {x, y, angle}; }
+
+void VisionTargets::fov_set(double degrees) {
+  half_fov = degrees / 2.0;
+  focal = (VISION_FOV_WIDTH / 2.0) / tan(util::to_rad(half_fov));
+}
+
+void VisionTargets::signature_add(int id, int kind, double width) {
+  if (id < 1 || id > MAX_SIGNATURES) {
+    printf("Vision Targets: signature %i is out of range!\n", id);
+    return;
+  }
+  signatures[id] = {kind, width};
+}
+
+void VisionTargets::tracking_set(double distance, int input_max_age) {
+  match_distance = distance;
+  max_age = input_max_age;
+}
+
+void VisionTargets::track_remove(int index) {
+  tracks[index] = tracks[tracks_used - 1];
+  tracks_used--;
+}
+
+void VisionTargets::blob_add(int kind, double x, double y, uint32_t now) {
+  // Update the closest track of the same kind, otherwise start a new one
+  int closest = -1;
+  double closest_distance = match_distance;
+  for (int i = 0; i < tracks_used; i++) {
+    double distance = hypot(tracks[i].x - x, tracks[i].y - y);
+    if (tracks[i].kind == kind && distance < closest_distance) {
+      closest = i;
+      closest_distance = distance;
+    }
+  }
+
+  if (closest >= 0) {
+    vision_track& track = tracks[closest];
+    // Only the first sighting in a frame raises confidence
+    if (track.last_seen != now) track.confidence = fmin(track.confidence + CONFIDENCE_HIT, 1.0);
+    track.x += (x - track.x) * 0.3;
+    track.y += (y - track.y) * 0.3;
+    track.last_seen = now;
+    track.hits++;
+    return;
+  }
+
+  // A full list gives up its least likely track
+  if (tracks_used >= MAX_TRACKS) {
+    int weakest = 0;
+    for (int i = 1; i < tracks_used; i++)
+      if (tracks[i].confidence < tracks[weakest].confidence) weakest = i;
+    track_remove(weakest);
+  }
+  tracks[tracks_used++] = {kind, x, y, CONFIDENCE_HIT, now, 1};
+}
+
+void VisionTargets::iterate() {
+  uint32_t now = pros::millis();
+  pose robot;
+  if (!odometry->pose_at(now - FRAME_LATENCY, robot)) robot = odometry->pose_get();
+
+  // Where the camera is and which way it faces
+  double heading = util::to_rad(robot.theta);
+  double camera_x = robot.x + camera.x * cos(heading) + camera.y * sin(heading);
+  double camera_y = robot.y - camera.x * sin(heading) + camera.y * cos(heading);
+  double facing = robot.theta + camera.theta;
+
+  // Nothing to do without a sensor plugged in
+  int count = sensor.get_object_count();
+  if (count == PROS_ERR) return;
+  count = std::min(count, MAX_BLOBS);
+  for (int i = 0; i < count; i++) {
+    pros::vision_object_s_t blob = sensor.get_by_size(i);
+    if (blob.signature == VISION_OBJECT_ERR_SIG || blob.signature > MAX_SIGNATURES || blob.width <= 0) continue;
+    const signature& match = signatures[blob.signature];
+    if (match.width == 0.0) continue;
+    // Blobs cut off by the edge of the frame look narrower, so they'd look too far away
+    if (blob.left_coord <= 0 || blob.left_coord + blob.width >= VISION_FOV_WIDTH) continue;
+
+    double bearing = util::to_deg(atan2(blob.x_middle_coord - VISION_FOV_WIDTH / 2.0, focal));
+    double range = focal * match.width / blob.width;
+    double angle = util::to_rad(facing + bearing);
+    blob_add(match.kind, camera_x + range * sin(angle), camera_y + range * cos(angle), now);
+  }
+
+  // Tracks that should have been seen and weren't lose confidence, old tracks are dropped
+  for (int i = tracks_used - 1; i >= 0; i--) {
+    vision_track& track = tracks[i];
+    if (track.last_seen != now) {
+      double distance = hypot(track.x - camera_x, track.y - camera_y);
+      double bearing = util::wrap_angle(util::to_deg(atan2(track.x - camera_x, track.y - camera_y)) - facing);
+      if (distance < VISIBLE_RANGE && fabs(bearing) < half_fov - 5.0)
+        track.confidence -= CONFIDENCE_MISS;
+    }
+    if (track.confidence <= 0.0 || (int)(now - track.last_seen) > max_age)
+      track_remove(i);
+  }
+}
+
+bool VisionTargets::nearest(int kind, double& x, double& y, double radius, double min_confidence) {
+  int best = -1;
+  double best_distance = radius;
+  for (int i = 0; i < tracks_used; i++) {
+    if (tracks[i].kind != kind || tracks[i].confidence < min_confidence) continue;
+    double distance = hypot(tracks[i].x - x, tracks[i].y - y);
+    if (distance <= best_distance) {
+      best = i;
+      best_distance = distance;
+    }
+  }
+  if (best < 0) return false;
+  x = tracks[best].x;
+  y = tracks[best].y;
+  return true;
+}
+
+odom VisionTargets::snap(int kind, odom target, double radius) {
+  nearest(kind, target.target.x, target.target.y, radius);
+  return target;
+}
+
+int VisionTargets::track_count() { return tracks_used; }
+
+vision_track VisionTargets::track_get(int index) {
+  if (index < 0 || index >= tracks_used) return {};
+  return tracks[index];
+}
+
+void VisionTargets::print() {
+  printf("Vision targets: %i tracked\n", tracks_used);
+  uint32_t now = pros::millis();
+  for (int i = 0; i < tracks_used; i++) {
+    const vision_track& track = tracks[i];
+    printf("  kind %i  x %7.2f  y %7.2f  confidence %.2f  %4lu ms ago  %i hits\n", track.kind, track.x, track.y, track.confidence, (unsigned long)(now - track.last_seen), track.hits);
+  }
+}
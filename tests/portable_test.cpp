@@ -0,0 +1,205 @@
+// Host tests for include/portable.hpp, run with `make test` from the project folder
+
+#include "portable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace ez;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                   \
+  do {                                                                     \
+    if (!(condition)) {                                                    \
+      printf("%s:%i: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+// An hour of 10ms ticks with a tracking wheel rolling over, summed the way Odometry does
+static void odometry_drift() {
+  const double TICKS_PER_INCH = 8192.0 / (2.0 * M_PI);  // Rotation sensor on a 2" wheel
+  const int TICKS = 60 * 60 * 100;
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int32_t> speed(-1500, 1500);  // Up to ~115 in/s
+
+  uint32_t raw = UINT32_MAX - 100000;  // Rolls over a few seconds in
+  uint32_t last = raw;
+  int64_t total = 0;
+  kahan_sum position;
+  for (int i = 0; i < TICKS; i++) {
+    raw += speed(random);
+    int32_t delta = tick_delta(raw, last);
+    last = raw;
+    total += delta;
+    position.add(delta / TICKS_PER_INCH);
+  }
+  CHECK(fabs(position.sum - total / TICKS_PER_INCH) < 0.01);
+
+  // One tick at a time far from the origin, a plain double drops the low bits of every add
+  const double STEP = 1.0 / TICKS_PER_INCH;
+  const double START = 1.0e10;
+  double naive = START;
+  kahan_sum far;
+  far.reset(START);
+  for (int i = 0; i < TICKS; i++) {
+    naive += STEP;
+    far.add(STEP);
+  }
+  CHECK(fabs(naive - (START + TICKS * STEP)) > 0.01);
+  CHECK(fabs(far.sum - (START + TICKS * STEP)) < 0.01);
+}
+
+static void tick_rollover() {
+  CHECK(tick_delta(5, UINT32_MAX - 4) == 10);
+  CHECK(tick_delta(UINT32_MAX - 4, 5) == -10);
+  CHECK(tick_delta(100, 100) == 0);
+}
+
+static void crc() {
+  const char* check = "123456789";
+  CHECK(crc16((const uint8_t*)check, strlen(check)) == 0x29B1);
+  CHECK(crc16(nullptr, 0) == 0xFFFF);
+}
+
+// Encodes, checks the encoding if one is given, then decodes back
+static void cobs_round_trip(const std::vector<uint8_t>& input, const std::vector<uint8_t>& expected = {}) {
+  std::vector<uint8_t> encoded(input.size() + input.size() / 254 + 1);
+  int encoded_length = cobs_encode(input.data(), input.size(), encoded.data());
+  encoded.resize(encoded_length);
+  CHECK(memchr(encoded.data(), 0, encoded.size()) == nullptr);
+  if (!expected.empty()) CHECK(encoded == expected);
+
+  std::vector<uint8_t> decoded(encoded.size());
+  int decoded_length = cobs_decode(encoded.data(), encoded.size(), decoded.data());
+  CHECK(decoded_length == (int)input.size());
+  decoded.resize(decoded_length < 0 ? 0 : decoded_length);
+  CHECK(decoded == input);
+}
+
+static void cobs() {
+  cobs_round_trip({}, {0x01});
+  cobs_round_trip({0x00}, {0x01, 0x01});
+  cobs_round_trip({0x00, 0x00}, {0x01, 0x01, 0x01});
+  cobs_round_trip({0x11, 0x22, 0x00, 0x33}, {0x03, 0x11, 0x22, 0x02, 0x33});
+  cobs_round_trip({0x11, 0x22, 0x33, 0x44}, {0x05, 0x11, 0x22, 0x33, 0x44});
+  cobs_round_trip({0x11, 0x00, 0x00, 0x00}, {0x02, 0x11, 0x01, 0x01, 0x01});
+
+  // Full blocks of 254 bytes
+  std::vector<uint8_t> block, expected = {0xFF};
+  for (int i = 1; i <= 254; i++)
+    block.push_back(i);
+  expected.insert(expected.end(), block.begin(), block.end());
+  cobs_round_trip(block, expected);
+  block.push_back(0xFF);
+  expected.push_back(0x02);
+  expected.push_back(0xFF);
+  cobs_round_trip(block, expected);
+
+  std::mt19937 random(2);
+  for (int i = 0; i < 1000; i++) {
+    std::vector<uint8_t> input(random() % 600);
+    for (auto& byte : input)
+      byte = random() % 4 == 0 ? 0 : random();
+    cobs_round_trip(input);
+  }
+
+  // Malformed frames
+  uint8_t output[8];
+  const uint8_t zero[] = {0x01, 0x00};
+  const uint8_t short_block[] = {0x05, 0x11, 0x22};
+  CHECK(cobs_decode(zero, sizeof(zero), output) == -1);
+  CHECK(cobs_decode(short_block, sizeof(short_block), output) == -1);
+}
+
+// Frames go through a ring buffer and a port that takes a few bytes at a time, then back together on the other side
+static void frame_loopback() {
+  const int MAX_PAYLOAD = 240;
+  byte_ring<2048> ring;
+  frame_collector<MAX_PAYLOAD + 8> collector;
+  std::mt19937 random(3);
+  std::vector<std::vector<uint8_t>> queued, received;
+  uint8_t encoded[MAX_PAYLOAD + FRAME_OVERHEAD + 4], raw[MAX_PAYLOAD + FRAME_OVERHEAD + 4];
+  uint8_t sequence = 0, expected_sequence = 0;
+  int dropped = 0, overflows = 0;
+
+  // Moves bytes out of the ring into the collector, like the port would
+  auto pump = [&](int port_free) {
+    while (port_free > 0 && ring.used() > 0) {
+      int length = std::min(port_free, ring.contiguous());
+      for (int i = 0; i < length; i++) {
+        int frame_length = collector.add(ring.data[ring.tail + i]);
+        if (frame_length <= 0) continue;
+        int raw_length = frame_decode(collector.data.data(), frame_length, raw);
+        CHECK(raw_length >= FRAME_OVERHEAD);
+        if (raw_length < FRAME_OVERHEAD) continue;
+        dropped += (uint8_t)(raw[1] - expected_sequence);
+        expected_sequence = raw[1] + 1;
+        received.emplace_back(raw + 2, raw + raw_length - 2);
+      }
+      ring.pop(length);
+      port_free -= length;
+    }
+  };
+
+  for (int tick = 0; tick < 5000; tick++) {
+    // Send a burst, some of which won't fit
+    for (int i = random() % 4; i > 0; i--) {
+      std::vector<uint8_t> payload(random() % (MAX_PAYLOAD + 1));
+      for (auto& byte : payload)
+        byte = random() % 3 == 0 ? 0 : random();
+      int length = frame_encode<MAX_PAYLOAD>(1, sequence, payload.data(), payload.size(), encoded);
+      int used = ring.used();
+      if (!ring.push(encoded, length)) {
+        CHECK(ring.used() == used);
+        overflows++;
+        continue;
+      }
+      queued.push_back(payload);
+      sequence++;
+    }
+
+    // The port only takes a little each tick
+    pump(random() % 200);
+  }
+  pump(ring.used());
+  CHECK(overflows > 0);
+  CHECK(dropped == 0);
+  CHECK(received == queued);
+
+  // A corrupted frame fails its CRC and the next one still comes through
+  std::vector<uint8_t> payload = {1, 2, 0, 3};
+  int length = frame_encode<MAX_PAYLOAD>(2, 0, payload.data(), payload.size(), encoded);
+  encoded[2] ^= 0x10;
+  int frame_length = 0;
+  for (int i = 0; i < length; i++)
+    frame_length = collector.add(encoded[i]);
+  CHECK(frame_length > 0 && frame_decode(collector.data.data(), frame_length, raw) == -1);
+  length = frame_encode<MAX_PAYLOAD>(2, 1, payload.data(), payload.size(), encoded);
+  for (int i = 0; i < length; i++)
+    frame_length = collector.add(encoded[i]);
+  CHECK(frame_decode(collector.data.data(), frame_length, raw) == (int)payload.size() + FRAME_OVERHEAD);
+  CHECK(memcmp(raw + 2, payload.data(), payload.size()) == 0);
+
+  // Too long to be a frame is dropped up to the next 0
+  for (int i = 0; i < MAX_PAYLOAD + 20; i++)
+    collector.add(0x55);
+  CHECK(collector.add(0) == -1);
+  CHECK(frame_encode<MAX_PAYLOAD>(1, 0, raw, MAX_PAYLOAD + 1, encoded) == -1);
+}
+
+int main() {
+  odometry_drift();
+  tick_rollover();
+  crc();
+  cobs();
+  frame_loopback();
+  if (failures == 0)
+    printf("All portable tests passed\n");
+  return failures == 0 ? 0 : 1;
+}